@@ -0,0 +1,72 @@
+#include "Batch.hpp"
+
+#include <cstring>
+#include <ostream>
+
+namespace wade {
+
+Batch::
+Batch(Game & a_game, bool a_status)
+    : m_game{a_game}
+    , m_status{a_status}
+{
+}
+
+Game::Result
+Batch::
+run(char const * a_begin, char const * a_end, std::ostream & a_os)
+{
+    m_commands = 0;
+    std::size_t line_number = 0;
+    auto line = a_begin;
+    while (line != a_end and m_game.result() == Game::Result::None)
+    {
+        auto const newline = static_cast<char const *>(std::memchr(line, '\n', static_cast<std::size_t>(a_end - line)));
+        auto const line_end = newline ? newline : a_end;
+        ++line_number;
+
+        auto const command = Command::parse(line, line_end);
+        line = newline ? newline + 1 : a_end;
+        if (command.type == Command::Type::None)
+        {
+            continue;
+        }
+
+        ++m_commands;
+        auto const ok = m_game.step(command).valid;
+        if (m_status)
+        {
+            write_status(line_number, command, ok, a_os);
+        }
+    }
+
+    a_os << "result=" << m_game.result()
+        << " commands=" << m_commands
+        << " revealed=" << m_game.revealed_count()
+        << " flagged=" << m_game.flagged_count()
+        << " seed=" << m_game.seed();
+    if (m_game.needs_guessing())
+    {
+        a_os << " needs_guessing=1";
+    }
+    a_os << '\n';
+    return m_game.result();
+}
+
+void
+Batch::
+write_status(std::size_t a_line, Command const & a_command, bool a_ok, std::ostream & a_os) const
+{
+    a_os << a_line << ' ' << a_command.name << ' ';
+    if (a_ok)
+    {
+        a_os << m_game.result();
+    }
+    else
+    {
+        a_os << "error";
+    }
+    a_os << ' ' << m_game.revealed_count() << ' ' << m_game.flagged_count() << '\n';
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Command.hpp"
+#include "Game.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace wade {
+
+// Run a script of commands against a game through its step API, without echoing commands, prompting or drawing
+// boards.
+//
+// Only the final result is written, plus, if asked for, one status line per command:
+//   <line> <command> <result> <revealed> <flagged>
+// where a command that could not be run shows "error" instead of its result.
+class Batch
+{
+public:
+    // Ctors.
+    Batch(Game &, bool a_status = false);
+
+    // Run commands from the script's lines until the game ends, which a quit command also does, or the script ends.
+    Game::Result run(char const * a_begin, char const * a_end, std::ostream &);
+
+    // Get number of commands run by the last run, not counting blank lines.
+    std::size_t commands() const { return m_commands; }
+
+private:
+
+    void write_status(std::size_t a_line, Command const &, bool a_ok, std::ostream &) const;
+
+    Game & m_game;
+    bool m_status;
+    std::size_t m_commands = 0;
+};
+
+}
@@ -1,16 +1,27 @@
 #include "Board.hpp"
 
+#include "Renderer.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <ostream>
+#include <string>
 
 namespace wade {
 
 Board::
 Board(std::size_t a_rows, std::size_t a_cols)
-    : m_board(a_rows, Row(a_cols, Cell::Zero))
+    : m_rows{a_rows}
+    , m_cols{a_cols}
+    , m_cells((a_rows + 2) * (a_cols + 2), Cell::Border)
 {
     assert(a_rows > 0);
     assert(a_cols > 0);
+    auto const down = static_cast<std::ptrdiff_t>(stride());
+    m_neighbors = {{-down - 1, -down, -down + 1, -1, +1, down - 1, down, down + 1}};
+    fill(Cell::Zero);
 }
 
 Board::
@@ -41,67 +52,48 @@ is_valid(Coord const & a_coord) const
     return is_valid(a_coord.row, a_coord.col);
 }
 
-void
+Coord
 Board::
-hide()
+coord(std::size_t a_index) const
 {
-    for (auto && row : m_board)
-    {
-        for (auto && cell : row)
-        {
-            cell = Cell::Hidden;
-        }
-    }
+    assert(a_index < size());
+    auto const row = static_cast<std::int64_t>(a_index / stride()) - 1;
+    auto const col = static_cast<std::int64_t>(a_index % stride()) - 1;
+    return Coord{row, col};
 }
 
-std::ostream &
+void
 Board::
-write(std::ostream & a_os) const
+fill(Cell a_cell)
 {
-    // Functions to write border along top and bottom.
-    auto write_digit_border =
-        [this, &a_os]()
+    // Rows are independent, so large boards fill bands of rows in parallel.
+    ThreadPool::for_each_band(rows(), cols(),
+        [this, a_cell](std::size_t a_begin, std::size_t a_end)
         {
-            // Write digits to make it easier to select a cell coordinate.
-            a_os << "  ";
-            for (std::size_t i = 0; i != cols(); ++i)
+            for (std::size_t i = a_begin; i != a_end; ++i)
             {
-                a_os << (i % 10) << ' ';
+                auto row = row_data(i);
+                std::fill(row, row + cols(), a_cell);
             }
-            a_os << std::endl;
-        };
-    auto write_border =
-        [this, &a_os]()
-        {
-            a_os << " |-";
-            for (std::size_t i = 1; i != cols(); ++i)
-            {
-                a_os << '-' << '-';
-            }
-            a_os << '|' << std::endl;
-        };
-
-    // Write top border.
-    write_digit_border();
-    write_border();
-
-    int i = 0;
-    for (auto && row : m_board)
-    {
-        // Write |cell|
-        a_os << (i % 10) << '|';
-        for (auto && cell : row)
-        {
-            a_os << cell << '|';
-        }
-        a_os << (i % 10) << std::endl;
-        ++i;
-    }
+        });
+}
 
-    // Write bottom border.
-    write_border();
-    write_digit_border();
+void
+Board::
+hide()
+{
+    fill(Cell::Hidden);
+}
 
+std::ostream &
+Board::
+write(std::ostream & a_os) const
+{
+    // Format into a buffer kept per thread and write it in one call.
+    thread_local std::string buffer{};
+    buffer.clear();
+    Renderer::format(*this, buffer);
+    a_os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
     return a_os;
 }
 
@@ -4,6 +4,7 @@
 #include "Coord.hpp"
 #include "Settings.hpp"
 
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <iosfwd>
@@ -11,6 +12,8 @@
 
 namespace wade {
 
+// Cells are stored in one contiguous row-major buffer surrounded by a ring of Cell::Border sentinels,
+// so every cell on the board has 8 neighbors in the buffer and neighbor access needs no bounds check.
 class Board
 {
 public:
@@ -19,50 +22,103 @@ public:
     Board(Settings const &);
 
     // Get numbers of rows and columns.
-    std::size_t rows() const;
-    std::size_t cols() const;
+    std::size_t rows() const { return m_rows; }
+    std::size_t cols() const { return m_cols; }
+
+    // Get distance between vertically adjacent cells in the buffer (includes the border columns).
+    std::size_t stride() const { return m_cols + 2; }
+
+    // Get number of cells in the buffer, including the border.
+    std::size_t size() const { return m_cells.size(); }
 
     // Determine if row and column is a valid board position.
     bool is_valid(std::size_t row, std::size_t col) const;
     bool is_valid(Coord const &) const;
 
+    // Convert between row and column and index into the buffer.
+    std::size_t index(std::size_t row, std::size_t col) const { return (row + 1) * stride() + (col + 1); }
+    std::size_t index(Coord const & a_coord) const { return index(a_coord.row, a_coord.col); }
+    Coord coord(std::size_t a_index) const;
+
+    // Get distances in the buffer from a cell to its 8 neighbors, worked out once per board. Thanks to the border,
+    // every cell on the board has all 8 in the buffer, so code looking only for values the border never has
+    // (Hidden, Flagged, numbers, Mine) can add them to any cell's index without checks.
+    using Neighbors = std::array<std::ptrdiff_t, 8>;
+    Neighbors const & neighbors() const { return m_neighbors; }
+
+    // Determine if all 8 neighbors of a cell are on the board.
+    bool is_interior(Coord const & a_coord) const
+    {
+        return a_coord.row > 0 and a_coord.col > 0
+            and static_cast<std::size_t>(a_coord.row) + 1 < rows() and static_cast<std::size_t>(a_coord.col) + 1 < cols();
+    }
+
+    // Call function with the buffer index of each neighbor of a cell that is on the board, in buffer order.
+    // Interior cells take the 8 neighbors unchecked; cells on an edge skip the border.
+    template<typename Function>
+    void for_each_neighbor(Coord const &, Function &&) const;
+
     // Access cell on the board.
-    Cell & at(std::size_t row, std::size_t col)             { assert(is_valid(row, col)); return m_board[row][col]; }
-    Cell const & at(std::size_t row, std::size_t col) const { assert(is_valid(row, col)); return m_board[row][col]; }
-    Cell & at(Coord const & a_coord)             { assert(is_valid(a_coord)); return m_board[a_coord.row][a_coord.col]; }
-    Cell const & at(Coord const & a_coord) const { assert(is_valid(a_coord)); return m_board[a_coord.row][a_coord.col]; }
+    Cell & at(std::size_t row, std::size_t col)             { assert(is_valid(row, col)); return m_cells[index(row, col)]; }
+    Cell const & at(std::size_t row, std::size_t col) const { assert(is_valid(row, col)); return m_cells[index(row, col)]; }
+    Cell & at(Coord const & a_coord)             { assert(is_valid(a_coord)); return m_cells[index(a_coord)]; }
+    Cell const & at(Coord const & a_coord) const { assert(is_valid(a_coord)); return m_cells[index(a_coord)]; }
+
+    // Access cell by index into the buffer, including border cells.
+    Cell & operator[](std::size_t a_index)             { assert(a_index < size()); return m_cells[a_index]; }
+    Cell const & operator[](std::size_t a_index) const { assert(a_index < size()); return m_cells[a_index]; }
+
+    // Get first cell of the buffer, to save or restore the whole buffer in bulk.
+    Cell * data()             { return m_cells.data(); }
+    Cell const * data() const { return m_cells.data(); }
+
+    // Get first cell of the given row, which is followed by the rest of the row.
+    Cell * row_data(std::size_t row)             { assert(row < rows()); return &m_cells[index(row, 0)]; }
+    Cell const * row_data(std::size_t row) const { assert(row < rows()); return &m_cells[index(row, 0)]; }
 
     // Determine if board has a mine at the given position.
     bool is_mine(std::size_t row, std::size_t col) const { return at(row, col) == Cell::Mine; }
     bool is_mine(Coord const & a_coord) const { return at(a_coord) == Cell::Mine; }
 
+    // Set every cell on the board to the given value, leaving the border intact.
+    void fill(Cell);
+
     void hide();
 
     std::ostream & write(std::ostream &) const;
 
 private:
 
-    using Row = std::vector<Cell>;
-    using Grid = std::vector<Row>;
+    using Cells = std::vector<Cell>;
 
-    Grid m_board = {};
+    std::size_t m_rows = 0;
+    std::size_t m_cols = 0;
+    Neighbors m_neighbors = {};
+    Cells m_cells = {};
 };
 
-inline
-std::size_t
-Board::
-rows() const
-{
-    return m_board.size();
-}
-
-inline
-std::size_t
+template<typename Function>
+void
 Board::
-cols() const
+for_each_neighbor(Coord const & a_coord, Function && a_function) const
 {
-    assert(rows() != 0);
-    return m_board[0].size();
+    assert(is_valid(a_coord));
+    auto const index = this->index(a_coord);
+    if (is_interior(a_coord))
+    {
+        for (auto && delta : m_neighbors)
+        {
+            a_function(index + delta);
+        }
+        return;
+    }
+    for (auto && delta : m_neighbors)
+    {
+        if (m_cells[index + delta] != Cell::Border)
+        {
+            a_function(index + delta);
+        }
+    }
 }
 
 std::ostream & operator<<(std::ostream &, Board const &);
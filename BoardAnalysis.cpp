@@ -0,0 +1,233 @@
+#include "BoardAnalysis.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <utility>
+
+namespace wade {
+
+namespace {
+
+using Word = std::uint64_t;
+constexpr std::size_t word_bits = 64;
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "bits_equal reads cells as little-endian words");
+
+// Get a bit for each of up to 64 cells, set if the cell has the given value. Cells are compared 8 at a time in
+// a word: a byte of the word is zero exactly where a cell matches, and its top bit is then gathered with the others.
+Word
+bits_equal(Cell const * a_cells, std::size_t a_count, Cell a_value)
+{
+    constexpr Word low_bits = 0x7F7F7F7F7F7F7F7F;
+    constexpr Word gather = 0x0102040810204080; // Moves bit 8k to bit 56 + k.
+    auto const value = static_cast<Word>(static_cast<unsigned char>(a_value)) * 0x0101010101010101;
+
+    Word bits = 0;
+    std::size_t g = 0;
+    for (; g + 8 <= a_count; g += 8)
+    {
+        Word word = 0;
+        std::memcpy(&word, a_cells + g, sizeof(word));
+        word ^= value;
+        auto const zero = ~(((word & low_bits) + low_bits) | word | low_bits);
+        bits |= (((zero >> 7) * gather) >> 56) << g;
+    }
+    for (; g != a_count; ++g)
+    {
+        bits |= Word{a_cells[g] == a_value} << g;
+    }
+    return bits;
+}
+
+}
+
+void
+BoardStats::
+add(BoardAnalysis const & a_analysis)
+{
+    openings.add(a_analysis.openings);
+    isolated.add(a_analysis.isolated);
+    three_bv.add(a_analysis.three_bv());
+}
+
+BoardStats &
+BoardStats::
+operator+=(BoardStats const & a_rhs)
+{
+    openings += a_rhs.openings;
+    isolated += a_rhs.isolated;
+    three_bv += a_rhs.three_bv;
+    return *this;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, BoardStats const & a_stats)
+{
+    a_os << "openings: " << a_stats.openings << '\n'
+        << "isolated: " << a_stats.isolated << '\n'
+        << "3bv: " << a_stats.three_bv
+        ;
+    return a_os;
+}
+
+BoardAnalysis
+BoardAnalyzer::
+analyze(Cell const * a_cells, std::size_t a_rows, std::size_t a_cols, std::size_t a_stride)
+{
+    // Runs hold columns, and each takes at most one label, with at most one run for every two columns of a row.
+    assert(a_cols < std::numeric_limits<Label>::max());
+    assert(a_rows * ((a_cols + 1) / 2) <= std::numeric_limits<Label>::max());
+    m_parent.clear();
+    m_above.clear();
+
+    // Keep bits for the empty cells of the rows above, at and below the row being scanned, with a padding word
+    // either side of each row. The rows above and below the board are border, so have none.
+    auto const words = (a_cols + word_bits - 1) / word_bits;
+    m_empty.assign(3 * (words + 2), 0);
+    auto up = &m_empty[1];
+    auto mid = &m_empty[words + 3];
+    auto down = &m_empty[2 * words + 5];
+    auto flag_empty =
+        [a_cells, a_cols, a_stride, words](std::size_t a_row, Word * a_bits)
+        {
+            auto const row = a_cells + a_row * a_stride;
+            for (std::size_t w = 0; w != words; ++w)
+            {
+                a_bits[w] = bits_equal(row + w * word_bits, std::min(word_bits, a_cols - w * word_bits), Cell::Zero);
+            }
+        };
+    if (a_rows != 0)
+    {
+        flag_empty(0, mid);
+    }
+
+    // West neighbor of bit c is bit c - 1, east neighbor is bit c + 1; the padding words supply the carries.
+    auto beside =
+        [](Word const * a_word)
+        {
+            return (a_word[0] << 1) | (a_word[-1] >> 63) | (a_word[0] >> 1) | (a_word[1] << 63);
+        };
+    auto around = [&beside](Word const * a_word) { return a_word[0] | beside(a_word); };
+
+    BoardAnalysis result{};
+    std::size_t joins = 0;
+    for (std::size_t i = 0; i != a_rows; ++i)
+    {
+        if (i + 1 != a_rows)
+        {
+            flag_empty(i + 1, down);
+        }
+        else
+        {
+            std::fill(down, down + words, 0);
+        }
+
+        // Count the numbers, cells neither empty nor mines, with no empty cell around them.
+        auto const row = a_cells + i * a_stride;
+        for (std::size_t w = 0; w != words; ++w)
+        {
+            auto const count = std::min(word_bits, a_cols - w * word_bits);
+            auto const cells = (count == word_bits) ? ~Word{0} : (Word{1} << count) - 1;
+            auto const numbers = cells & ~mid[w] & ~bits_equal(row + w * word_bits, count, Cell::Mine);
+            auto const near = around(up + w) | beside(mid + w) | around(down + w);
+            result.isolated += static_cast<std::size_t>(__builtin_popcountll(numbers & ~near));
+        }
+
+        // Find each run of empty cells in the row from the bits where runs start and end, and join it to the runs in
+        // the row above that touch it, including diagonally. A run that touches none starts a new region.
+        m_runs.clear();
+        std::size_t above = 0;
+        auto join =
+            [this, &above, &joins](std::size_t a_first, std::size_t a_last)
+            {
+                Run run{static_cast<Label>(a_first), static_cast<Label>(a_last), 0};
+                while (above != m_above.size() and m_above[above].last + 1 < run.first)
+                {
+                    ++above;
+                }
+                auto touching = above;
+                if (touching != m_above.size() and m_above[touching].first <= run.last + 1)
+                {
+                    run.label = m_above[touching].label;
+                    for (++touching; touching != m_above.size() and m_above[touching].first <= run.last + 1; ++touching)
+                    {
+                        joins += unite(run.label, m_above[touching].label) ? 1 : 0;
+                    }
+                }
+                else
+                {
+                    run.label = static_cast<Label>(m_parent.size());
+                    m_parent.push_back(run.label);
+                }
+                m_runs.push_back(run);
+            };
+        std::size_t first = 0; // Start of a run carried over from the word before.
+        for (std::size_t w = 0; w != words; ++w)
+        {
+            auto const bits = mid[w];
+            auto starts = bits & ~((bits << 1) | (mid[w - 1] >> 63));
+            auto ends = bits & ~((bits >> 1) | (mid[w + 1] << 63));
+            while (ends != 0)
+            {
+                if (starts != 0 and (starts & -starts) <= (ends & -ends))
+                {
+                    first = w * word_bits + static_cast<std::size_t>(__builtin_ctzll(starts));
+                    starts &= starts - 1;
+                }
+                join(first, w * word_bits + static_cast<std::size_t>(__builtin_ctzll(ends)));
+                ends &= ends - 1;
+            }
+            if (starts != 0)
+            {
+                first = w * word_bits + static_cast<std::size_t>(__builtin_ctzll(starts));
+            }
+        }
+
+        std::swap(m_above, m_runs);
+        std::swap(up, mid);
+        std::swap(mid, down);
+    }
+
+    // Each label starts a region and each join merges two.
+    result.openings = m_parent.size() - joins;
+    return result;
+}
+
+BoardAnalyzer::Label
+BoardAnalyzer::
+find(Label a_label)
+{
+    // Path halving: point each label visited at its grandparent.
+    while (m_parent[a_label] != a_label)
+    {
+        m_parent[a_label] = m_parent[m_parent[a_label]];
+        a_label = m_parent[a_label];
+    }
+    return a_label;
+}
+
+bool
+BoardAnalyzer::
+unite(Label a, Label b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b)
+    {
+        return false;
+    }
+
+    // Keep the older label as the root, so roots stay near the rows above.
+    if (b < a)
+    {
+        std::swap(a, b);
+    }
+    m_parent[b] = a;
+    return true;
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Cell.hpp"
+#include "Sketch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace wade {
+
+// How much work a real board is to clear.
+struct BoardAnalysis
+{
+    std::size_t openings = 0; // Regions of empty cells, each cleared with its surrounding numbers by one click.
+    std::size_t isolated = 0; // Numbers next to no empty cell, each needing a click of its own.
+
+    // Get the clicks needed to clear the board without flags or chords.
+    std::size_t three_bv() const { return openings + isolated; }
+};
+
+// Distributions of the analyses of many boards.
+struct BoardStats
+{
+    Sketch openings = {};
+    Sketch isolated = {};
+    Sketch three_bv = {};
+
+    void add(BoardAnalysis const &);
+
+    // Add counts from another set of stats, e.g. to combine stats gathered on separate threads.
+    BoardStats & operator+=(BoardStats const &);
+};
+
+std::ostream & operator<<(std::ostream &, BoardStats const &);
+
+// Analyze real boards in a single pass over their rows, reusing buffers from one board to the next.
+//
+// Rows are read 8 cells at a time into bits for their empty cells, as MineField keeps its mines, so isolated numbers
+// are counted 64 at a time. Each run of empty cells in a row is labelled, and joined with union-find to the runs of
+// the row above that it touches, so only the runs of two rows and one entry per label are kept, rather than a
+// visited mark for every cell.
+class BoardAnalyzer
+{
+public:
+    // Analyze any board laid out as Board is, with a ring of Cell::Border around the cells.
+    template<typename Board>
+    BoardAnalysis analyze(Board const & a_board)
+    {
+        return analyze(&a_board[a_board.index(0, 0)], a_board.rows(), a_board.cols(), a_board.stride());
+    }
+
+    // Analyze cells in rows a_stride apart starting at the first cell, with a border around them.
+    BoardAnalysis analyze(Cell const * a_cells, std::size_t a_rows, std::size_t a_cols, std::size_t a_stride);
+
+private:
+
+    using Label = std::uint32_t;
+
+    using Word = std::uint64_t;
+
+    // Empty cells from first to last column.
+    struct Run
+    {
+        Label first;
+        Label last;
+        Label label;
+    };
+    using Runs = std::vector<Run>;
+
+    Label find(Label);
+    bool unite(Label, Label); // Return false if already joined.
+
+    std::vector<Label> m_parent = {};
+    std::vector<Word> m_empty = {}; // Bits of three rows.
+    Runs m_above = {};
+    Runs m_runs = {};
+};
+
+}
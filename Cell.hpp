@@ -1,11 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 
 namespace wade {
 
 // Possible states for cell on the board.
-enum class Cell : int
+enum class Cell : std::int8_t
 {
     Mine  =  -1, // Cell is a mine.
     Zero  =   0, // Adjacent to 0 mines.
@@ -19,8 +20,19 @@ enum class Cell : int
     Eight =   8, // Adjacent to 8 mines.
     Flagged = 9, // Player has flagged cell as a mine.
     Hidden = 10, // Cell is hidden from the player.
+    Border = 11, // Sentinel ring around the board: never a mine and never played.
 };
 
+// Get character shown for a cell.
+inline
+char
+to_char(Cell a_cell)
+{
+    // Indexed by cell value + 1, from Mine to Border.
+    static constexpr char chars[] = {'X', ' ', '1', '2', '3', '4', '5', '6', '7', '8', 'F', '#', ' '};
+    return chars[static_cast<std::int8_t>(a_cell) + 1];
+}
+
 std::ostream & operator<<(std::ostream &, Cell);
 
 }
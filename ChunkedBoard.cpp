@@ -0,0 +1,312 @@
+#include "ChunkedBoard.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace wade {
+
+constexpr std::size_t ChunkedBoard::tile_bits;
+constexpr std::size_t ChunkedBoard::tile_size;
+constexpr std::int64_t ChunkedBoard::limit;
+
+namespace {
+
+// Offsets for all around a cell, including diagonals.
+Coord const neighbors[] = {{-1, -1}, {-1, 0}, {-1, +1}, {0, -1}, {0, +1}, {+1, -1}, {+1, 0}, {+1, +1}};
+
+// Cached tiles may not go below this, so a select's neighborhood is always cached at once.
+constexpr std::size_t min_tiles = 16;
+
+}
+
+ChunkedBoard::
+ChunkedBoard(Random::Seed a_seed, double a_density, std::size_t a_cache_bytes, std::size_t a_max_reveal)
+    : m_seed{a_seed != 0 ? a_seed : Random::make_seed()}
+    , m_max_tiles{std::max(min_tiles, a_cache_bytes / (sizeof(Tile) + 4 * sizeof(void *)))}
+    , m_max_reveal{a_max_reveal}
+{
+    // Scale the density to a threshold on 64 random bits.
+    auto const density = std::min(std::max(a_density, 0.0), 1.0);
+    m_threshold = (density >= 1.0) ? ~Word{0} : static_cast<Word>(std::ldexp(density, 64));
+}
+
+Cell
+ChunkedBoard::
+at(Coord const & a_coord)
+{
+    if (not is_valid(a_coord))
+    {
+        return Cell::Border;
+    }
+    auto found = m_play.find(key(a_coord));
+    if (found != m_play.end())
+    {
+        auto const local = offset(a_coord);
+        auto const row = local >> tile_bits;
+        auto const bit = Word{1} << (local & (tile_size - 1));
+        if (found->second.revealed[row] & bit)
+        {
+            return real(a_coord);
+        }
+        if (found->second.flagged[row] & bit)
+        {
+            return Cell::Flagged;
+        }
+    }
+    return Cell::Hidden;
+}
+
+bool
+ChunkedBoard::
+select(Coord const & a_coord)
+{
+    assert(is_valid(a_coord));
+    if (at(a_coord) == Cell::Flagged)
+    {
+        return true;
+    }
+    if (is_mine(a_coord))
+    {
+        return false;
+    }
+    reveal(a_coord);
+    return true;
+}
+
+void
+ChunkedBoard::
+reveal(Coord const & a_coord)
+{
+    // Breadth-first fill, revealing each cell as it is reached, so a reveal that hits the limit stops with a compact
+    // area around the selected cell rather than a long trail across the board.
+    std::size_t revealed = 0;
+    auto visit =
+        [this, &revealed](Coord const & a_cell)
+        {
+            if (revealed == m_max_reveal or not is_valid(a_cell))
+            {
+                return;
+            }
+            auto & play = play_tile(key(a_cell));
+            auto const local = offset(a_cell);
+            auto const row = local >> tile_bits;
+            auto const bit = Word{1} << (local & (tile_size - 1));
+            if (play.revealed[row] & bit)
+            {
+                return;
+            }
+            auto const cell = real(a_cell);
+            if (cell == Cell::Mine)
+            {
+                return;
+            }
+            if (play.flagged[row] & bit)
+            {
+                play.flagged[row] &= ~bit;
+                --m_flagged_count;
+            }
+            play.revealed[row] |= bit;
+            ++m_revealed_count;
+            ++revealed;
+            if (cell == Cell::Zero)
+            {
+                m_queue.push_back(a_cell);
+            }
+        };
+
+    // Selecting a revealed empty cell carries on revealing around it.
+    m_queue.clear();
+    if (at(a_coord) == Cell::Zero)
+    {
+        m_queue.push_back(a_coord);
+    }
+    else
+    {
+        visit(a_coord);
+    }
+    for (std::size_t next = 0; next != m_queue.size() and revealed != m_max_reveal; ++next)
+    {
+        for (auto && offset : neighbors)
+        {
+            visit(m_queue[next] + offset);
+        }
+    }
+    m_queue.clear();
+}
+
+void
+ChunkedBoard::
+toggle_flag(Coord const & a_coord)
+{
+    assert(is_valid(a_coord));
+    auto & play = play_tile(key(a_coord));
+    auto const local = offset(a_coord);
+    auto const row = local >> tile_bits;
+    auto const bit = Word{1} << (local & (tile_size - 1));
+    if (play.revealed[row] & bit)
+    {
+        return;
+    }
+    play.flagged[row] ^= bit;
+    if (play.flagged[row] & bit)
+    {
+        ++m_flagged_count;
+    }
+    else
+    {
+        --m_flagged_count;
+    }
+}
+
+void
+ChunkedBoard::
+view(Coord const & a_top_left, Board & a_window)
+{
+    for (std::size_t i = 0; i != a_window.rows(); ++i)
+    {
+        auto row = a_window.row_data(i);
+        for (std::size_t j = 0; j != a_window.cols(); ++j)
+        {
+            row[j] = at(a_top_left + Coord{static_cast<std::int64_t>(i), static_cast<std::int64_t>(j)});
+        }
+    }
+}
+
+ChunkedBoard::Tile const &
+ChunkedBoard::
+tile(Key const & a_key)
+{
+    if (m_last_tile and m_last_key == a_key)
+    {
+        return *m_last_tile;
+    }
+
+    auto found = m_tiles.find(a_key);
+    if (found != m_tiles.end())
+    {
+        m_uses.splice(m_uses.begin(), m_uses, found->second.use);
+    }
+    else
+    {
+        // Make room by evicting the least recently used tiles; they can be generated again when next touched.
+        while (m_tiles.size() >= m_max_tiles)
+        {
+            m_tiles.erase(m_uses.back());
+            m_uses.pop_back();
+        }
+        found = m_tiles.emplace(a_key, Tile{}).first;
+        generate(a_key, found->second);
+        m_uses.push_front(a_key);
+        found->second.use = m_uses.begin();
+    }
+
+    // The most recently used tile is never the one evicted, so the pointer stays valid until the next lookup.
+    m_last_key = a_key;
+    m_last_tile = &found->second;
+    return found->second;
+}
+
+ChunkedBoard::PlayTile &
+ChunkedBoard::
+play_tile(Key const & a_key)
+{
+    return m_play[a_key];
+}
+
+ChunkedBoard::Bits
+ChunkedBoard::
+mines(Key const & a_key, Word a_rows, Word a_cols) const
+{
+    // Get the mines in the cells that are in both a row and a column of the tile given by bits of a_rows and a_cols.
+    // Tiles off the board have none.
+    Bits bits{};
+    auto const keys = limit >> tile_bits;
+    if (a_key.row < -keys or a_key.row >= keys or a_key.col < -keys or a_key.col >= keys)
+    {
+        return bits;
+    }
+
+    // Each cell's random word is the splitmix64 word at its index in a sequence seeded from the board's seed and the
+    // tile's position only, so the tile always comes out the same and any cell can be drawn on its own.
+    std::uint64_t state = m_seed ^ (static_cast<std::uint64_t>(a_key.row) * 0x9E3779B97F4A7C15);
+    state = Random::mix(state) ^ static_cast<std::uint64_t>(a_key.col);
+    auto const base = Random::mix(state);
+    for (auto rows = a_rows; rows != 0; rows &= rows - 1)
+    {
+        auto const i = static_cast<std::size_t>(__builtin_ctzll(rows));
+        for (auto cols = a_cols; cols != 0; cols &= cols - 1)
+        {
+            auto const j = static_cast<std::size_t>(__builtin_ctzll(cols));
+            auto cell_state = base + (i * tile_size + j) * 0x9E3779B97F4A7C15;
+            bits[i] |= Word{Random::mix(cell_state) < m_threshold} << j;
+        }
+    }
+
+    // Keep the starting cells clear.
+    for (std::int64_t i = -1; i <= 1; ++i)
+    {
+        for (std::int64_t j = -1; j <= 1; ++j)
+        {
+            Coord const coord{i, j};
+            if (key(coord) == a_key)
+            {
+                auto const local = offset(coord);
+                bits[local >> tile_bits] &= ~(Word{1} << (local & (tile_size - 1)));
+            }
+        }
+    }
+    return bits;
+}
+
+void
+ChunkedBoard::
+generate(Key const & a_key, Tile & a_tile) const
+{
+    // Numbers on the tile's edges depend on the mines in the 8 tiles around it, but only on those in their rows and
+    // columns next to the tile: the last of the tiles above and to the left, the first of those below and to the right.
+    Word const all = ~Word{0};
+    Word const last = Word{1} << (tile_size - 1);
+    Word const first = 1;
+    Word const lines[] = {last, all, first};
+    std::array<std::array<Bits, 3>, 3> grid{};
+    for (std::int64_t i = 0; i != 3; ++i)
+    {
+        for (std::int64_t j = 0; j != 3; ++j)
+        {
+            grid[i][j] = mines(Key{a_key.row + i - 1, a_key.col + j - 1}, lines[i], lines[j]);
+        }
+    }
+
+    // Look up a mine by row and column relative to the tile, from -1 to tile_size.
+    auto const size = static_cast<std::int64_t>(tile_size);
+    auto is_mine =
+        [&grid, size](std::int64_t a_row, std::int64_t a_col) -> int
+        {
+            auto const tile_row = (a_row < 0) ? 0 : (a_row < size) ? 1 : 2;
+            auto const tile_col = (a_col < 0) ? 0 : (a_col < size) ? 1 : 2;
+            auto const word = grid[tile_row][tile_col][static_cast<std::size_t>(a_row & (size - 1))];
+            return static_cast<int>((word >> (a_col & (size - 1))) & 1);
+        };
+
+    for (std::int64_t i = 0; i != size; ++i)
+    {
+        for (std::int64_t j = 0; j != size; ++j)
+        {
+            auto & cell = a_tile.cells[static_cast<std::size_t>(i * size + j)];
+            if (is_mine(i, j))
+            {
+                cell = Cell::Mine;
+                continue;
+            }
+            int count = 0;
+            for (auto && offset : neighbors)
+            {
+                count += is_mine(i + offset.row, j + offset.col);
+            }
+            cell = static_cast<Cell>(count);
+        }
+    }
+}
+
+}
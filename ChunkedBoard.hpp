@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Cell.hpp"
+#include "Coord.hpp"
+#include "Random.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace wade {
+
+// Effectively unbounded board, played in square tiles that are only generated once touched.
+//
+// A cell's mine depends only on the seed and the cell's position, so any tile can be generated, thrown away and
+// generated again identically, and the cells along a tile's edges can be drawn without the rest of the tile.
+// Generated tiles (mines and numbers) are cached, and the least recently used are evicted to stay within a memory
+// budget. What the player has revealed and flagged is kept as two bits per cell for every tile they have touched, so
+// memory grows with the explored area rather than the size of the board.
+//
+// The cells around (0, 0) never have mines, so the game starts by selecting (0, 0).
+class ChunkedBoard
+{
+public:
+    static constexpr std::size_t tile_bits = 6;
+    static constexpr std::size_t tile_size = std::size_t{1} << tile_bits; // Rows and columns in a tile.
+
+    // Rows and columns run from -limit to limit - 1, so stepping to a neighbor or across a view never overflows.
+    static constexpr std::int64_t limit = std::int64_t{1} << 62;
+
+    // Determine if a cell is on the board.
+    static bool is_valid(Coord const & a_coord)
+    {
+        return a_coord.row >= -limit and a_coord.row < limit and a_coord.col >= -limit and a_coord.col < limit;
+    }
+
+    // Ctors. Each cell is a mine with probability a_density. A select reveals at most a_max_reveal cells; selecting
+    // an empty cell that was already revealed carries on from there.
+    ChunkedBoard(Random::Seed, double a_density, std::size_t a_cache_bytes = std::size_t{64} << 20,
+        std::size_t a_max_reveal = std::size_t{1} << 20);
+
+    Random::Seed seed() const { return m_seed; }
+
+    // Get cell as the player sees it: Hidden, Flagged or, once revealed, its number. Cells off the board are Border.
+    Cell at(Coord const &);
+
+    // Determine if there is a mine at the cell.
+    bool is_mine(Coord const & a_coord) { return real(a_coord) == Cell::Mine; }
+
+    // Reveal a cell and, if it is empty, the area around it. Return false if it is a mine.
+    bool select(Coord const &);
+
+    // Flag a hidden cell as a suspected mine, or unflag a flagged cell.
+    void toggle_flag(Coord const &);
+
+    // Copy the player's view of the area with the given top-left corner into the window board, which sets its size.
+    void view(Coord const & a_top_left, Board & a_window);
+
+    // Get counts of revealed and flagged cells.
+    std::size_t revealed_count() const { return m_revealed_count; }
+    std::size_t flagged_count() const { return m_flagged_count; }
+
+    // Get number of tiles cached, and of tiles the player has touched.
+    std::size_t cached_tiles() const { return m_tiles.size(); }
+    std::size_t explored_tiles() const { return m_play.size(); }
+
+private:
+
+    using Word = std::uint64_t;
+    using Bits = std::array<Word, tile_size>; // One word per row, one bit per column.
+
+    // Tile position: the row and column of its top-left cell, each shifted right by tile_bits.
+    struct Key
+    {
+        std::int64_t row = 0;
+        std::int64_t col = 0;
+
+        bool operator==(Key const & a_rhs) const { return row == a_rhs.row and col == a_rhs.col; }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(Key const & a_key) const
+        {
+            std::uint64_t state = static_cast<std::uint64_t>(a_key.row) * 0x9E3779B97F4A7C15;
+            state ^= static_cast<std::uint64_t>(a_key.col);
+            return static_cast<std::size_t>(Random::mix(state));
+        }
+    };
+
+    // Generated tile: every cell's real value, Cell::Mine or its number.
+    struct Tile
+    {
+        std::array<Cell, tile_size * tile_size> cells = {};
+        std::list<Key>::iterator use = {}; // Position in the recently used list.
+    };
+
+    // What the player has done in a tile.
+    struct PlayTile
+    {
+        Bits revealed = {};
+        Bits flagged = {};
+    };
+
+    static Key key(Coord const & a_coord)
+    {
+        return Key{a_coord.row >> tile_bits, a_coord.col >> tile_bits};
+    }
+    static std::size_t offset(Coord const & a_coord)
+    {
+        auto const mask = static_cast<std::int64_t>(tile_size - 1);
+        return static_cast<std::size_t>(((a_coord.row & mask) << tile_bits) | (a_coord.col & mask));
+    }
+
+    Cell real(Coord const & a_coord) { return tile(key(a_coord)).cells[offset(a_coord)]; }
+    Tile const & tile(Key const &);
+    PlayTile & play_tile(Key const &);
+    Bits mines(Key const &, Word a_rows = ~Word{0}, Word a_cols = ~Word{0}) const;
+    void generate(Key const &, Tile &) const;
+    void reveal(Coord const &);
+
+    Random::Seed m_seed;
+    Word m_threshold; // A cell is a mine if its random word is below this.
+    std::size_t m_max_tiles;
+    std::size_t m_max_reveal;
+
+    std::unordered_map<Key, Tile, KeyHash> m_tiles = {};
+    std::list<Key> m_uses = {}; // Cached tiles from most to least recently used.
+    Key m_last_key = {}; // Most recently used tile, checked before the hash map.
+    Tile const * m_last_tile = nullptr;
+
+    std::unordered_map<Key, PlayTile, KeyHash> m_play = {};
+    std::size_t m_revealed_count = 0;
+    std::size_t m_flagged_count = 0;
+    std::vector<Coord> m_queue = {}; // Empty cells revealed by the current select, in the order they were reached.
+};
+
+}
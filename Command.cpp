@@ -0,0 +1,139 @@
+#include "Command.hpp"
+
+#include <limits>
+#include <ostream>
+
+namespace wade {
+
+namespace {
+
+bool is_space(char a_ch) { return a_ch == ' ' or a_ch == '\t' or a_ch == '\r'; }
+
+// Take the next word from [a_pos, a_end), advancing a_pos past it. Return an empty token if none is left.
+Token
+next_token(char const * & a_pos, char const * a_end)
+{
+    while (a_pos != a_end and is_space(*a_pos))
+    {
+        ++a_pos;
+    }
+    auto const begin = a_pos;
+    while (a_pos != a_end and not is_space(*a_pos))
+    {
+        ++a_pos;
+    }
+    return Token{begin, static_cast<std::size_t>(a_pos - begin)};
+}
+
+// Look up a command by name: switch on the first character, then check the rest of the short or long form.
+Command::Type
+find_type(Token const & a_name)
+{
+    using Type = Command::Type;
+    auto is = [&a_name](char const * a_long) { return a_name.size == 1 or a_name == a_long; };
+    switch (a_name.data[0])
+    {
+        case 'q': return is("quit") ? Type::Quit : Type::Invalid;
+        case 'h': return is("help") ? Type::Help : Type::Invalid;
+        case '?': return (a_name.size == 1) ? Type::Help : Type::Invalid;
+        case 's': return is("select") ? Type::Select
+            : (a_name == "save") ? Type::Save
+            : (a_name == "stats") ? Type::Stats
+            : Type::Invalid;
+        case 'f': return is("flag") ? Type::Flag : Type::Invalid;
+        case 'c': return is("chord") ? Type::Chord : Type::Invalid;
+        case 'b': return is("board") ? Type::Board : Type::Invalid;
+        case 'a': return is("auto") ? Type::Auto : Type::Invalid;
+        default: return Type::Invalid;
+    }
+}
+
+}
+
+bool
+to_number(Token const & a_token, std::int64_t & a_number)
+{
+    auto pos = a_token.begin();
+    auto const negative = (pos != a_token.end() and (*pos == '-' or *pos == '+')) ? (*pos++ == '-') : false;
+    if (pos == a_token.end())
+    {
+        return false;
+    }
+
+    // Accumulate the magnitude, checking for overflow before each digit.
+    std::uint64_t const limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + negative;
+    std::uint64_t magnitude = 0;
+    for (; pos != a_token.end(); ++pos)
+    {
+        auto const digit = static_cast<unsigned>(*pos - '0');
+        if (digit > 9 or magnitude > (limit - digit) / 10)
+        {
+            return false;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    a_number = negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+    return true;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, Token const & a_token)
+{
+    a_os.write(a_token.data, static_cast<std::streamsize>(a_token.size));
+    return a_os;
+}
+
+constexpr std::size_t Command::type_count;
+
+Command
+Command::
+parse(char const * a_begin, char const * a_end)
+{
+    Command command{};
+    auto pos = a_begin;
+    command.name = next_token(pos, a_end);
+    if (command.name.empty())
+    {
+        return command;
+    }
+
+    command.type = find_type(command.name);
+    if (command.type == Type::Select or command.type == Type::Flag or command.type == Type::Chord)
+    {
+        // Expect exactly a row and a column.
+        auto const row = next_token(pos, a_end);
+        auto const col = next_token(pos, a_end);
+        command.valid = to_number(row, command.coord.row)
+            and to_number(col, command.coord.col)
+            and next_token(pos, a_end).empty();
+    }
+    else if (command.type == Type::Save)
+    {
+        // Expect exactly one file name.
+        command.path = next_token(pos, a_end);
+        command.valid = not command.path.empty() and next_token(pos, a_end).empty();
+    }
+    return command;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, Command::Type a_type)
+{
+    switch (a_type)
+    {
+        case Command::Type::None:    a_os << "none"; break;
+        case Command::Type::Quit:    a_os << "quit"; break;
+        case Command::Type::Help:    a_os << "help"; break;
+        case Command::Type::Select:  a_os << "select"; break;
+        case Command::Type::Flag:    a_os << "flag"; break;
+        case Command::Type::Chord:   a_os << "chord"; break;
+        case Command::Type::Board:   a_os << "board"; break;
+        case Command::Type::Auto:    a_os << "auto"; break;
+        case Command::Type::Save:    a_os << "save"; break;
+        case Command::Type::Stats:   a_os << "stats"; break;
+        case Command::Type::Invalid: a_os << "invalid"; break;
+    }
+    return a_os;
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Coord.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+
+namespace wade {
+
+// View of characters owned by someone else, such as a word in an input line.
+struct Token
+{
+    char const * data = nullptr;
+    std::size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    char const * begin() const { return data; }
+    char const * end() const { return data + size; }
+
+    // Determine if token has the given characters.
+    bool operator==(char const * a_text) const
+    {
+        return std::strlen(a_text) == size and std::memcmp(data, a_text, size) == 0;
+    }
+};
+
+// Convert token to a number, like std::from_chars: the whole token must be an optionally signed decimal number that
+// fits. Return false, leaving the number unchanged, if not.
+bool to_number(Token const &, std::int64_t &);
+
+std::ostream & operator<<(std::ostream &, Token const &);
+
+// Command typed by the player, parsed from one input line without allocating.
+struct Command
+{
+    enum class Type
+    {
+        None, // Blank line.
+        Quit,
+        Help,
+        Select,
+        Flag,
+        Chord, // Select the hidden neighbors of a number whose mines are all flagged.
+        Board,
+        Auto,
+        Save, // Save a snapshot of the game.
+        Stats, // Show the metrics of every game so far.
+        Invalid, // Unknown command name.
+    };
+    static constexpr std::size_t type_count = static_cast<std::size_t>(Type::Invalid) + 1;
+
+    Type type = Type::None;
+    Token name = {}; // First word of the line, pointing into the line.
+    Coord coord = {}; // Coordinate for Select, Flag and Chord.
+    Token path = {}; // File for Save, pointing into the line.
+    bool valid = true; // False if the arguments do not match the command's usage.
+
+    // Parse a line: a command name followed by its arguments, separated by spaces or tabs.
+    // Tokens point into the line, which must outlive the command.
+    static Command parse(char const * a_begin, char const * a_end);
+};
+
+// Write the long name of a command type.
+std::ostream & operator<<(std::ostream &, Command::Type);
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Cell.hpp"
+#include "Coord.hpp"
+#include "MineField.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace wade {
+
+// Board whose size is fixed at compile time, for the standard presets. Cells are laid out as in Board, row-major in
+// a ring of Cell::Border sentinels, but held in a std::array, and the stride and neighbor offsets are constants, so
+// index math folds away and loops over the board have constant bounds the compiler can unroll.
+template<std::size_t R, std::size_t C>
+class FixedBoard
+{
+public:
+    // Distances in the buffer to the cell below and to all 8 neighbors of a cell.
+    static constexpr std::ptrdiff_t down = static_cast<std::ptrdiff_t>(C + 2);
+    static constexpr std::array<std::ptrdiff_t, 8> neighbors = {{
+        -down - 1, -down, -down + 1, -1, +1, down - 1, down, down + 1}};
+
+    // Ctors.
+    FixedBoard()
+    {
+        m_cells.fill(Cell::Border);
+        fill(Cell::Zero);
+    }
+
+    // Get numbers of rows and columns, distance between vertically adjacent cells and number of cells in the buffer.
+    static constexpr std::size_t rows() { return R; }
+    static constexpr std::size_t cols() { return C; }
+    static constexpr std::size_t stride() { return C + 2; }
+    static constexpr std::size_t size() { return (R + 2) * (C + 2); }
+
+    // Determine if row and column is a valid board position.
+    static constexpr bool is_valid(std::size_t row, std::size_t col) { return row < R and col < C; }
+    static constexpr bool is_valid(Coord const & a_coord)
+    {
+        return a_coord.row >= 0 and a_coord.col >= 0 and is_valid(a_coord.row, a_coord.col);
+    }
+
+    // Convert between row and column and index into the buffer.
+    static constexpr std::size_t index(std::size_t row, std::size_t col) { return (row + 1) * stride() + (col + 1); }
+    static constexpr std::size_t index(Coord const & a_coord) { return index(a_coord.row, a_coord.col); }
+    static constexpr Coord coord(std::size_t a_index)
+    {
+        return Coord{static_cast<std::int64_t>(a_index / stride()) - 1, static_cast<std::int64_t>(a_index % stride()) - 1};
+    }
+
+    // Access cell on the board.
+    Cell & at(Coord const & a_coord)             { assert(is_valid(a_coord)); return m_cells[index(a_coord)]; }
+    Cell const & at(Coord const & a_coord) const { assert(is_valid(a_coord)); return m_cells[index(a_coord)]; }
+
+    // Access cell by index into the buffer, including border cells.
+    Cell & operator[](std::size_t a_index)             { assert(a_index < size()); return m_cells[a_index]; }
+    Cell const & operator[](std::size_t a_index) const { assert(a_index < size()); return m_cells[a_index]; }
+
+    // Set every cell on the board to the given value, leaving the border intact.
+    void fill(Cell a_cell)
+    {
+        for (std::size_t i = 0; i != R; ++i)
+        {
+            for (std::size_t j = 0; j != C; ++j)
+            {
+                m_cells[index(i, j)] = a_cell;
+            }
+        }
+    }
+
+    void hide() { fill(Cell::Hidden); }
+
+    // Write every cell of the board: Cell::Mine for mines, else the number of adjacent mines.
+    void count_adjacent(MineField const & a_mines)
+    {
+        assert(a_mines.rows() == R and a_mines.cols() == C);
+        for (std::size_t i = 0; i != R; ++i)
+        {
+            a_mines.count_row(i, &m_cells[index(i, 0)]);
+        }
+    }
+
+private:
+
+    std::array<Cell, (R + 2) * (C + 2)> m_cells;
+};
+
+template<std::size_t R, std::size_t C>
+constexpr std::array<std::ptrdiff_t, 8> FixedBoard<R, C>::neighbors;
+
+// Call function with a null pointer to the FixedBoard type for the given size, if it is a standard preset: beginner
+// (9x9), intermediate (16x16) or expert (16x30), with any number of mines. Return false without calling it otherwise.
+template<typename Function>
+bool
+with_preset_board(std::size_t a_rows, std::size_t a_cols, Function && a_function)
+{
+    if (a_rows == 9 and a_cols == 9)
+    {
+        a_function(static_cast<FixedBoard<9, 9> *>(nullptr));
+    }
+    else if (a_rows == 16 and a_cols == 16)
+    {
+        a_function(static_cast<FixedBoard<16, 16> *>(nullptr));
+    }
+    else if (a_rows == 16 and a_cols == 30)
+    {
+        a_function(static_cast<FixedBoard<16, 30> *>(nullptr));
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+}
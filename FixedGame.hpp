@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Cell.hpp"
+#include "Coord.hpp"
+#include "FixedBoard.hpp"
+#include "Game.hpp"
+#include "MineField.hpp"
+#include "Random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace wade {
+
+// Game on a FixedBoard, for simulating many games of a standard size. It places mines and reveals cells exactly as
+// Game does, so a game with the same seed plays out the same, but keeps no solver, renderer or command handling,
+// and every buffer is part of the object, so restarting and selecting never allocate.
+template<typename Board>
+class FixedGame
+{
+public:
+    // Ctors.
+    FixedGame(std::size_t a_mines)
+        : m_mines{Board::rows(), Board::cols()}
+        , m_mine_count{std::min(a_mines, Board::rows() * Board::cols() - 1)}
+    {
+    }
+
+    // Start a new game with mines placed from the seed.
+    void restart(Random::Seed a_seed)
+    {
+        m_seed = a_seed;
+        Random random{m_seed};
+        m_mines.place(m_mine_count, random);
+        m_real_board.count_adjacent(m_mines);
+        m_play_board.hide();
+        m_revealed_count = 0;
+        m_result = Game::Result::None;
+    }
+
+    // Select a valid cell, revealing it and, if it is empty, the area around it.
+    Game::Result select(Coord const & a_coord)
+    {
+        assert(Board::is_valid(a_coord));
+        auto const start = Board::index(a_coord);
+        if (m_real_board[start] == Cell::Mine)
+        {
+            m_result = Game::Result::Lost;
+            return m_result;
+        }
+
+        // Reveal cells as they are reached, so the play board itself marks what has been visited; only empty cells
+        // go on the stack, and each at most once.
+        std::size_t top = 0;
+        auto reveal =
+            [this, &top](std::size_t a_index)
+            {
+                auto & cell = m_play_board[a_index];
+                if (cell != Cell::Hidden and cell != Cell::Flagged)
+                {
+                    return;
+                }
+                cell = m_real_board[a_index];
+                ++m_revealed_count;
+                if (cell == Cell::Zero)
+                {
+                    m_stack[top++] = a_index;
+                }
+            };
+        reveal(start);
+        while (top != 0)
+        {
+            auto const index = m_stack[--top];
+            for (auto && delta : Board::neighbors)
+            {
+                reveal(index + delta);
+            }
+        }
+
+        if (m_revealed_count == Board::rows() * Board::cols() - m_mine_count)
+        {
+            m_result = Game::Result::Won;
+        }
+        return m_result;
+    }
+
+    Game::Result result() const { return m_result; }
+    Random::Seed seed() const { return m_seed; }
+    Board const & real_board() const { return m_real_board; }
+    Board const & play_board() const { return m_play_board; }
+    std::size_t revealed_count() const { return m_revealed_count; }
+
+private:
+
+    MineField m_mines;
+    std::size_t m_mine_count;
+    Board m_real_board = {};
+    Board m_play_board = {};
+    std::array<std::size_t, Board::rows() * Board::cols()> m_stack = {}; // Empty cells whose neighbors are next.
+    Random::Seed m_seed = 0;
+    std::size_t m_revealed_count = 0;
+    Game::Result m_result = Game::Result::None;
+};
+
+}
@@ -0,0 +1,244 @@
+#include "FloodFill.hpp"
+
+#include "Metrics.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace wade {
+
+FloodFill::
+FloodFill(Board const & a_board, std::size_t a_parallel_threshold)
+    : m_parallel_threshold{a_parallel_threshold}
+{
+    reserve(a_board);
+}
+
+void
+FloodFill::
+reserve(Board const & a_board)
+{
+    auto const words = (a_board.size() + 63) / 64;
+    if (m_visited.size() < words)
+    {
+        m_visited.resize(words, 0);
+    }
+    m_spans.reserve(a_board.rows() + a_board.cols());
+}
+
+template<typename Claim>
+void
+FloodFill::
+push_span(Board const & a_real_board, Spans & a_spans, Claim const & a_claim, std::size_t a_index)
+{
+    // Extend a claimed empty cell to the full run of empty cells in its row and claim the numbered cell at each end.
+    auto left = a_index;
+    while (a_real_board[left - 1] == Cell::Zero and a_claim(left - 1))
+    {
+        --left;
+    }
+    a_claim(left - 1);
+
+    auto right = a_index;
+    while (a_real_board[right + 1] == Cell::Zero and a_claim(right + 1))
+    {
+        ++right;
+    }
+    a_claim(right + 1);
+
+    a_spans.push_back(Span{left, right});
+}
+
+template<typename Claim, typename Stop>
+void
+FloodFill::
+grow(Board const & a_real_board, Spans & a_spans, Claim const & a_claim, Stop const & a_stop)
+{
+    // Claim every cell diagonally or directly adjacent to a span in another row, starting new spans at empty cells.
+    // A new span ends at a cell that is not empty or already claimed, so the scan carries on past it.
+    auto scan =
+        [&a_real_board, &a_spans, &a_claim](std::size_t a_first, std::size_t a_last)
+        {
+            for (auto i = a_first; i <= a_last; ++i)
+            {
+                if (a_claim(i) and a_real_board[i] == Cell::Zero)
+                {
+                    push_span(a_real_board, a_spans, a_claim, i);
+                    i = a_spans.back().right;
+                }
+            }
+        };
+
+    auto const stride = a_real_board.stride();
+    while (not a_spans.empty() and not a_stop())
+    {
+        auto const span = a_spans.back();
+        a_spans.pop_back();
+        scan(span.left - 1 - stride, span.right + 1 - stride);
+        scan(span.left - 1 + stride, span.right + 1 + stride);
+    }
+}
+
+FloodFill::Indices const &
+FloodFill::
+fill(Board const & a_real_board, Board const & a_play_board, std::size_t a_start)
+{
+    assert(a_real_board.size() == a_play_board.size());
+    Metrics::Timer timer{&Metrics::flood_fill};
+    reserve(a_real_board);
+    m_revealed.clear();
+    m_spans.clear();
+
+    // Claim a cell if the player cannot see it yet and this fill has not already revealed it.
+    // Border cells are never Hidden, so they stop the fill without a bounds check.
+    auto claim =
+        [this, &a_play_board](std::size_t a_index)
+        {
+            auto const cell = a_play_board[a_index];
+            if ((cell != Cell::Hidden and cell != Cell::Flagged)
+                or is_visited(a_index)
+                )
+            {
+                return false;
+            }
+            set_visited(a_index);
+            m_revealed.push_back(a_index);
+            return true;
+        };
+
+    if (claim(a_start) and a_real_board[a_start] == Cell::Zero)
+    {
+        push_span(a_real_board, m_spans, claim, a_start);
+    }
+
+    // Fill serially until the region turns out to be large enough to be worth the threads.
+    auto const threshold = (m_parallel_threshold != 0) ? m_parallel_threshold : a_real_board.size();
+    m_peak_spans = m_spans.size();
+    grow(a_real_board, m_spans, claim,
+        [this, threshold]()
+        {
+            m_peak_spans = std::max(m_peak_spans, m_spans.size());
+            return m_revealed.size() >= threshold;
+        });
+    if (not m_spans.empty())
+    {
+        fill_parallel(a_real_board, a_play_board);
+        collect_parallel();
+        record_metrics();
+        return m_revealed;
+    }
+
+    // Leave the visited bitmap clear for the next fill, touching only the words this fill set.
+    for (auto && index : m_revealed)
+    {
+        reset_visited(index);
+    }
+
+    record_metrics();
+    return m_revealed;
+}
+
+void
+FloodFill::
+record_metrics() const
+{
+    Metrics::record(&Metrics::revealed, m_revealed.size());
+    Metrics::record(&Metrics::frontier, m_peak_spans);
+}
+
+void
+FloodFill::
+fill_parallel(Board const & a_real_board, Board const & a_play_board)
+{
+    // Claim a cell for this fill; of two tasks reaching it at once, only one sets the bit.
+    auto claim =
+        [this, &a_play_board](std::size_t a_index)
+        {
+            auto const cell = a_play_board[a_index];
+            if (cell != Cell::Hidden and cell != Cell::Flagged)
+            {
+                return false;
+            }
+            auto const word = &m_visited[a_index / 64];
+            auto const bit = Word{1} << (a_index % 64);
+            return (__atomic_load_n(word, __ATOMIC_RELAXED) & bit) == 0
+                and (__atomic_fetch_or(word, bit, __ATOMIC_RELAXED) & bit) == 0;
+        };
+
+    // In each round, every task takes a share of the waiting spans and grows the region from them for a bounded
+    // number of spans, then hands back what it has left, so that the work is spread out again for the next round.
+    constexpr std::size_t spans_per_round = std::size_t{1} << 14;
+    auto & pool = ThreadPool::shared();
+    auto const tasks = 4 * pool.size();
+    m_tasks.resize(tasks);
+    while (not m_spans.empty())
+    {
+        m_peak_spans = std::max(m_peak_spans, m_spans.size());
+        for (std::size_t t = 0; t != tasks; ++t)
+        {
+            m_tasks[t].assign(m_spans.begin() + m_spans.size() * t / tasks,
+                m_spans.begin() + m_spans.size() * (t + 1) / tasks);
+        }
+        pool.parallel_for(tasks,
+            [this, &a_real_board, &claim](std::size_t a_task, std::size_t)
+            {
+                std::size_t grown = 0;
+                grow(a_real_board, m_tasks[a_task], claim, [&grown]() { return grown++ == spans_per_round; });
+            });
+
+        m_spans.clear();
+        for (auto && spans : m_tasks)
+        {
+            m_spans.insert(m_spans.end(), spans.begin(), spans.end());
+        }
+    }
+}
+
+void
+FloodFill::
+collect_parallel()
+{
+    // Clear the bits of the cells revealed before the switch, leaving only the parallel fill's cells set.
+    for (auto && index : m_revealed)
+    {
+        reset_visited(index);
+    }
+
+    // Count the set bits in bands of words, then write each band's cells after those of the bands before it,
+    // clearing the bits, so the cells come out row-major.
+    auto & pool = ThreadPool::shared();
+    auto const bands = 4 * pool.size();
+    auto const words = m_visited.size();
+    m_band_ends.assign(bands, 0);
+    pool.parallel_for(bands,
+        [this, bands, words](std::size_t a_band, std::size_t)
+        {
+            std::size_t count = 0;
+            for (auto w = words * a_band / bands; w != words * (a_band + 1) / bands; ++w)
+            {
+                count += static_cast<std::size_t>(__builtin_popcountll(m_visited[w]));
+            }
+            m_band_ends[a_band] = count;
+        });
+    auto const serial_count = m_revealed.size();
+    std::partial_sum(m_band_ends.begin(), m_band_ends.end(), m_band_ends.begin());
+    m_revealed.resize(serial_count + m_band_ends.back());
+
+    pool.parallel_for(bands,
+        [this, bands, words, serial_count](std::size_t a_band, std::size_t)
+        {
+            auto out = m_revealed.begin() + serial_count + (a_band != 0 ? m_band_ends[a_band - 1] : 0);
+            for (auto w = words * a_band / bands; w != words * (a_band + 1) / bands; ++w)
+            {
+                for (auto word = m_visited[w]; word != 0; word &= word - 1)
+                {
+                    *out++ = w * 64 + static_cast<std::size_t>(__builtin_ctzll(word));
+                }
+                m_visited[w] = 0;
+            }
+        });
+}
+
+}
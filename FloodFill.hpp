@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Board.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wade {
+
+// Scanline flood fill that finds the cells revealed by selecting a cell: the selected cell and, if it is empty (0),
+// the whole connected empty region plus the numbered cells bordering it.
+//
+// Buffers are kept between fills, so only the first fill on a board allocates, and each cell is claimed at most once.
+//
+// A fill that reveals more than a threshold of cells finishes on the shared thread pool: tasks grow the region from
+// slices of the remaining frontier, claiming cells with atomic visited bits. The cells revealed are the same either
+// way; those revealed after the switch are listed in row-major order, so the result never depends on the threads.
+class FloodFill
+{
+public:
+    using Indices = std::vector<std::size_t>;
+
+    // Ctors. A threshold of 0 keeps every fill serial.
+    FloodFill() = default;
+    FloodFill(Board const &, std::size_t a_parallel_threshold = 0);
+
+    // Find cells revealed by selecting the given buffer index.
+    // Only Hidden or Flagged cells of the play board are revealed, and the boards are not modified.
+    Indices const & fill(Board const & a_real_board, Board const & a_play_board, std::size_t a_start);
+
+    // Get buffer indices of cells revealed by the last fill, in discovery order up to any switch to parallel.
+    Indices const & revealed() const { return m_revealed; }
+
+private:
+
+    // Run of claimed empty cells in one row, inclusive.
+    struct Span
+    {
+        std::size_t left = 0;
+        std::size_t right = 0;
+    };
+    using Spans = std::vector<Span>;
+
+    using Word = std::uint64_t;
+
+    void reserve(Board const &);
+    void fill_parallel(Board const & a_real_board, Board const & a_play_board);
+    void collect_parallel();
+    void record_metrics() const;
+
+    // Scanline steps shared by the serial and parallel fills, which claim cells differently.
+    template<typename Claim>
+    static void push_span(Board const & a_real_board, Spans &, Claim const &, std::size_t a_index);
+    template<typename Claim, typename Stop>
+    static void grow(Board const & a_real_board, Spans &, Claim const &, Stop const &);
+
+    bool is_visited(std::size_t a_index) const { return (m_visited[a_index / 64] >> (a_index % 64)) & 1; }
+    void set_visited(std::size_t a_index) { m_visited[a_index / 64] |= Word{1} << (a_index % 64); }
+    void reset_visited(std::size_t a_index) { m_visited[a_index / 64] &= ~(Word{1} << (a_index % 64)); }
+
+    std::size_t m_parallel_threshold = 0;
+    std::vector<Word> m_visited = {}; // One bit per buffer index; all clear between fills.
+    Spans m_spans = {};
+    Indices m_revealed = {};
+    std::vector<Spans> m_tasks = {}; // Spans each task of the parallel fill has yet to scan around.
+    std::vector<std::size_t> m_band_ends = {}; // Cells the parallel fill revealed up to the end of each band of words.
+    std::size_t m_peak_spans = 0; // Most spans waiting at once during the last fill.
+};
+
+}
+
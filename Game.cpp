@@ -1,12 +1,18 @@
 #include "Game.hpp"
 
+#include "Generator.hpp"
+#include "Metrics.hpp"
+#include "Snapshot.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <istream>
 #include <iterator>
 #include <ostream>
-#include <queue>
-#include <random>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -14,96 +20,98 @@ namespace wade {
 
 Game::
 Game(Settings const & a_settings)
-    : m_real_board{a_settings}
+    : m_settings{a_settings}
+    , m_real_board{a_settings}
     , m_play_board{a_settings}
+    , m_mines{a_settings}
+    , m_flood_fill{m_real_board, a_settings.parallel_fill}
+    , m_solver{m_play_board}
 {
-    make_mines(a_settings.mines);
-    m_play_board.hide();
+    Metrics::Scope scope{};
+    restart(a_settings.seed);
 }
 
 void
 Game::
-make_mines(std::size_t a_mines)
+restart(Random::Seed a_seed)
 {
-    // Limit the number of mines: must have at least 1 empty space.
-    a_mines = std::min(a_mines, (m_real_board.rows() * m_real_board.cols()) - 1);
+    m_seed = (a_seed != 0) ? a_seed : Random::make_seed();
 
-    m_mine_coords.clear();
+    m_mines_pending = m_settings.no_guess;
+    m_needs_guessing = false;
+    if (m_mines_pending)
+    {
+        m_mines.clear();
+        count_adjacent_mines();
+    }
+    else
+    {
+        make_mines(m_settings.mines);
+    }
+    hide_board();
+}
 
-    std::random_device rd{}; // Will be used to obtain a seed for the random number engine.
-    std::mt19937 gen{rd()}; // Standard mersenne_twister_engine seeded with rd().
+void
+Game::
+place_mines(MineField const & a_mines)
+{
+    assert(a_mines.rows() == m_real_board.rows() and a_mines.cols() == m_real_board.cols());
+    m_mines = a_mines;
+    m_mines_pending = false;
+    count_adjacent_mines();
+    hide_board();
+}
 
-    // Distributions for rows and columns.
-    std::uniform_int_distribution<> row_dist{0, static_cast<int>(m_real_board.rows() - 1)};
-    std::uniform_int_distribution<> col_dist{0, static_cast<int>(m_real_board.cols() - 1)};
+void
+Game::
+hide_board()
+{
+    m_result = Result::None;
+    m_play_board.hide();
+    m_solver.reset(m_play_board);
+    m_flagged_known_mines = 0;
 
-    // Generate random mine locations.
-    for (std::size_t i = 0; i != a_mines; ++i)
-    {
-        // Keep trying to generate a coordinate until we get a unique one.
-        Coord coord{};
-        while (1)
-        {
-            auto row = row_dist(gen);
-            auto col = col_dist(gen);
-            coord = Coord{row, col};
-            if (m_mine_coords.find(coord) == std::cend(m_mine_coords))
-            {
-                break;
-            }
-        }
+    m_hidden_count = m_play_board.rows() * m_play_board.cols();
+    m_flagged_count = 0;
+    m_revealed_count = 0;
+    m_clicks = 0;
+}
 
-        m_mine_coords.insert(coord);
-        m_real_board.at(coord) = Cell::Mine;
-    }
+void
+Game::
+make_mines(std::size_t a_mines)
+{
+    Metrics::Timer timer{&Metrics::generate};
+
+    // Limit the number of mines: must have at least 1 empty space.
+    auto const cells = m_real_board.rows() * m_real_board.cols();
+    a_mines = std::min(a_mines, cells - 1);
+
+    Random random{m_seed};
+    m_mines.place(a_mines, random);
 
     count_adjacent_mines();
 }
 
-
 void
 Game::
-count_adjacent_mines()
+make_no_guess_mines(Coord const & a_first)
 {
-    // Increment count for each cell adjacent to a mine.
-    for (auto && coord : m_mine_coords)
-    {
-        for (auto && offset : offsets())
-        {
-            auto adj_coord = coord + offset;
-            if (not m_real_board.is_valid(adj_coord)
-                or m_real_board.is_mine(adj_coord))
-            {
-                continue;
-            }
-
-            // Relying on Cell enum Zero, One, etc. values to correspond directly to values.
-            static_assert(static_cast<int>(Cell::Zero) == 0, "Cell enum values must correspond to int values");
-            static_assert(static_cast<int>(Cell::Eight) == 8, "Cell enum values must correspond to int values");
-            Cell cell = m_real_board.at(adj_coord);
-            int cell_value = static_cast<int>(cell);
-            ++cell_value;
-            m_real_board.at(adj_coord) = static_cast<Cell>(cell_value);
-        }
-    }
+    Metrics::Timer timer{&Metrics::generate};
+
+    // Generate with every core; a game already running on a pool worker generates on its own thread.
+    Generator generator{m_settings, &ThreadPool::shared()};
+    m_needs_guessing = not generator.generate(a_first, m_seed, m_mines);
+    m_mines_pending = false;
+    count_adjacent_mines();
 }
 
-Game::Coords
+void
 Game::
-offsets()
+count_adjacent_mines()
 {
-    // Offsets for all around a coord, including diagonals.
-    static std::vector<Coord> coord_offsets = {
-          {-1, -1}
-        , {-1,  0}
-        , {-1, +1}
-        , { 0, -1}
-        , { 0, +1}
-        , {+1, -1}
-        , {+1,  0}
-        , {+1, +1}
-        };
-    return coord_offsets;
+    // Fill the whole real board from the mine bit planes in one pass.
+    m_mines.count_adjacent(m_real_board);
 }
 
 Game::Result
@@ -115,8 +123,7 @@ play(std::istream & a_is, std::ostream & a_os)
     static std::string const prompt = "> ";
 
     // Show user the board and available commands to begin.
-    a_os << m_play_board;
-    handle_help_cmd(a_os);
+    write_intro(a_os);
     a_os << prompt;
 
     // Read each line.
@@ -125,75 +132,162 @@ play(std::istream & a_is, std::ostream & a_os)
     {
         a_os << line << '\n';
 
-        // Split line into words (space-delimited).
-        std::vector<std::string> words{};
-        std::stringstream ss{line};
-        std::string word{};
-        while (std::getline(ss, word, ' '))
-        {
-            words.push_back(word);
-        }
-
-        bool const keep_playing = handle_cmd(words, a_os);
+        // Parse in place: the command's words point into the line, whose buffer is reused for each line.
+        auto const command = Command::parse(line.data(), line.data() + line.size());
+        auto const frames = m_renderer.frames();
+        bool const keep_playing = handle_cmd(command, a_os);
         if (not keep_playing)
         {
             break;
         }
 
-        a_os << prompt;
-    }
-
-    a_os << m_real_board;
-    if (m_result != Result::Quit)
-    {
-        if (m_result == Result::Won)
-        {
-            a_os << "You won!" << std::endl;
-        }
-        else if (m_result == Result::Lost)
+        // A command that drew no frame leaves its text below the last one, which may scroll it off its place on the
+        // screen, so draw the next frame afresh.
+        if (m_renderer.frames() == frames)
         {
-            a_os << "Sorry, you lost..." << std::endl;
+            m_renderer.reset();
         }
+
+        a_os << prompt;
     }
 
+    write_outcome(a_os);
     return m_result;
 }
 
-bool
+void
+Game::
+write_intro(std::ostream & a_os)
+{
+    m_renderer.write(m_play_board, a_os);
+    handle_help_cmd(a_os);
+
+    // The help may scroll the frame above it, so draw the next one afresh.
+    m_renderer.reset();
+}
+
+void
 Game::
-handle_cmd(std::vector<std::string> const & a_words, std::ostream & a_os)
+write_outcome(std::ostream & a_os)
 {
-    if (a_words.empty())
+    m_renderer.write(m_real_board, a_os);
+    if (m_result == Result::Won)
+    {
+        a_os << "You won!" << std::endl;
+    }
+    else if (m_result == Result::Lost)
     {
-        return true;
+        a_os << "Sorry, you lost..." << std::endl;
     }
+}
 
-    // Handle commands.
-    auto && cmd = a_words.front();
-    if (cmd == "quit" or cmd == "q")
+void
+Game::
+set_recorder(Recorder * a_recorder)
+{
+    m_recorder = a_recorder;
+    if (m_recorder)
     {
-        m_result = Result::Quit;
-        return false;
+        m_recorder->start(*this);
     }
-    else if (cmd == "help" or cmd == "h" or cmd == "?")
+}
+
+bool
+Game::
+is_applicable(Command const & a_command) const
+{
+    // Commands that take a coordinate need a valid one on the board.
+    switch (a_command.type)
     {
-        handle_help_cmd(a_os);
+        case Command::Type::Select:
+        case Command::Type::Flag:
+        case Command::Type::Chord:
+            return a_command.valid and m_play_board.is_valid(a_command.coord);
+
+        default:
+            return a_command.type != Command::Type::Invalid;
     }
-    else if (cmd == "select" or cmd == "s")
+}
+
+void
+Game::
+apply(Command const & a_command)
+{
+    if (m_recorder)
     {
-        handle_select_cmd(a_words, a_os);
+        m_recorder->record(a_command);
     }
-    else if (cmd == "flag" or cmd == "f")
+    switch (a_command.type)
     {
-        handle_flag_cmd(a_words, a_os);
+        case Command::Type::Select:
+        case Command::Type::Flag:
+        case Command::Type::Chord:
+        case Command::Type::Auto:
+            ++m_clicks;
+            break;
+
+        default:
+            break;
     }
-    else if (cmd == "board" or cmd == "b")
+}
+
+bool
+Game::
+handle_cmd(Command const & a_command, std::ostream & a_os)
+{
+    Metrics::Scope scope{};
+    Metrics::Timer timer{a_command.type};
+
+    if (m_result == Result::None and is_applicable(a_command))
     {
-        a_os << m_play_board;
+        apply(a_command);
     }
-    else
+
+    // Handle commands.
+    switch (a_command.type)
     {
-        a_os << "Invalid command: '" << cmd << "'" << std::endl;
+        case Command::Type::None:
+            return true;
+
+        case Command::Type::Quit:
+            m_result = Result::Quit;
+            return false;
+
+        case Command::Type::Help:
+            handle_help_cmd(a_os);
+            break;
+
+        case Command::Type::Select:
+            handle_select_cmd(a_command, a_os);
+            break;
+
+        case Command::Type::Flag:
+            handle_flag_cmd(a_command, a_os);
+            break;
+
+        case Command::Type::Chord:
+            handle_chord_cmd(a_command, a_os);
+            break;
+
+        case Command::Type::Board:
+            m_renderer.write(m_play_board, a_os);
+            break;
+
+        case Command::Type::Auto:
+            handle_auto_cmd(a_os);
+            break;
+
+        case Command::Type::Save:
+            handle_save_cmd(a_command, a_os);
+            break;
+
+        case Command::Type::Stats:
+            Metrics::global().write(a_os) << std::endl;
+            break;
+
+        case Command::Type::Invalid:
+            a_os << "Invalid command: '" << a_command.name << "'" << std::endl;
+            break;
     }
 
     // Keep playing until have a result.
@@ -210,162 +304,373 @@ handle_help_cmd(std::ostream & a_os)
         << "help: Show this help message\n"
         << "select: Select square: " << select_cmd_usage() << '\n'
         << "flag: Flag square as suspected mine: " << flag_cmd_usage() << '\n'
+        << "chord: Select all squares around a number whose mines are flagged: " << chord_cmd_usage() << '\n'
         << "board: Show the board\n"
+        << "save: Save the game to resume later with --restore: " << save_cmd_usage() << '\n'
+        << "auto: Select all squares that are certainly safe and flag all certain mines\n"
+        << "stats: Show where the time of every game so far went, as JSON\n"
         ;
 }
 
 void
 Game::
-handle_select_cmd(std::vector<std::string> const & a_words, std::ostream & a_os)
+handle_select_cmd(Command const & a_command, std::ostream & a_os)
 {
-    auto write_usage = [&a_os]()
-        {
-            a_os << "usage: " << select_cmd_usage() << '\n';
-        };
-    if (a_words.size() != 3)
+    if (not a_command.valid)
     {
-        write_usage();
+        a_os << "usage: " << select_cmd_usage() << '\n';
         return;
     }
 
-    try
+    if (not m_real_board.is_valid(a_command.coord))
     {
-        auto row = std::stoi(a_words[1]);
-        auto col = std::stoi(a_words[2]);
-        auto coord = Coord{row, col};
+        write_invalid_coord(a_command.coord, a_os);
+        return;
+    }
 
-        if (not m_real_board.is_valid(coord))
-        {
-            auto max_row = static_cast<decltype(row)>(m_real_board.rows() - 1);
-            auto max_col = static_cast<decltype(col)>(m_real_board.cols() - 1);
-            a_os << "Coordinate " << coord << " is invalid"
-                << ": Select a coordinate from " << Coord{0, 0} << " to " << Coord{max_row, max_col}
-                << std::endl;
-            return;
-        }
+    bool const generating = m_mines_pending;
+    if (select(a_command.coord) != Result::Lost)
+    {
+        m_renderer.write(m_play_board, a_os);
+    }
+    if (generating and m_needs_guessing)
+    {
+        a_os << "No board that needs no guessing was found in " << Generator::max_attempts
+            << " attempts, so this one may need a guess" << std::endl;
+    }
+}
+
+Game::Delta const &
+Game::
+step(Command const & a_command)
+{
+    Metrics::Scope scope{};
+    Metrics::Timer timer{a_command.type};
+
+    m_delta.changes.clear();
+    m_delta.valid = true;
+    m_delta.needs_guessing = false;
+    m_recording = true;
 
-        // Selected a mine, so lost.
-        if (m_mine_coords.find(coord) != std::cend(m_mine_coords))
+    if (not is_applicable(a_command))
+    {
+        m_delta.valid = false;
+    }
+    else if (m_result == Result::None)
+    {
+        bool const generating = m_mines_pending;
+        apply(a_command);
+        switch (a_command.type)
         {
-            m_result = Result::Lost;
-            return;
+            case Command::Type::Select:
+                select(a_command.coord);
+                m_delta.needs_guessing = generating and m_needs_guessing;
+                break;
+
+            case Command::Type::Flag:
+                toggle_flag(a_command.coord);
+                break;
+
+            case Command::Type::Chord:
+                chord(a_command.coord);
+                break;
+
+            case Command::Type::Auto:
+                autoplay();
+                break;
+
+            case Command::Type::Save:
+                m_delta.valid = a_command.valid
+                    and Snapshot::save(*this, std::string{a_command.path.begin(), a_command.path.end()});
+                break;
+
+            case Command::Type::Quit:
+                m_result = Result::Quit;
+                break;
+
+            // Commands that only show things change nothing.
+            case Command::Type::Invalid:
+            case Command::Type::None:
+            case Command::Type::Help:
+            case Command::Type::Board:
+            case Command::Type::Stats:
+                break;
         }
+    }
 
-        show_more_board(coord);
-        check_for_win();
-        a_os << m_play_board;
+    m_recording = false;
+    m_delta.result = m_result;
+    return m_delta;
+}
+
+Game::Result
+Game::
+select(Coord const & a_coord)
+{
+    assert(m_real_board.is_valid(a_coord));
+
+    if (m_mines_pending)
+    {
+        make_no_guess_mines(a_coord);
     }
-    catch (...)
+
+    // Selected a mine, so lost.
+    if (m_mines.is_mine(a_coord))
     {
-        write_usage();
+        m_result = Result::Lost;
+        return m_result;
     }
+
+    show_more_board(a_coord);
+    check_for_win();
+    return m_result;
 }
 
 void
 Game::
 show_more_board(Coord const & selected_coord)
 {
-    // Use breadth-first search to show more area of the board.
-    CoordSet visited{};
-    std::queue<Coord> q{};
-    q.push(selected_coord);
-
-    while (not q.empty())
+    // Show every cell the flood fill reveals from the selected cell.
+    auto && revealed = m_flood_fill.fill(m_real_board, m_play_board, m_real_board.index(selected_coord));
+    for (auto && index : revealed)
     {
-        auto && coord = q.front();
-        q.pop();
-
-        // Visit coordinate by showing more of the real board.
-        m_play_board.at(coord) = m_real_board.at(coord);
-        visited.insert(coord);
-
-        // We can see cells that border a mine, but it acts as a wall and we cannot queue this adjacent cell,
-        // so only queue empty (0) cells.
-        auto cell = m_real_board.at(coord);
-        int cell_value = static_cast<int>(cell);
-        if (cell_value != 0)
+        if (m_play_board[index] == Cell::Flagged)
         {
-            continue;
+            --m_flagged_count;
         }
-
-        for (auto && offset : offsets())
+        else
         {
-            auto adj_coord = coord + offset;
-            if (not m_real_board.is_valid(adj_coord)
-                or visited.find(adj_coord) != std::cend(visited)
-                )
-            {
-                // Skip invalid coordinates and already-visited cells.
-                continue;
-            }
-
-            // Queue adjacent coordinate to be visited.
-            q.push(adj_coord);
+            --m_hidden_count;
         }
+        m_play_board[index] = m_real_board[index];
     }
+    if (m_recording)
+    {
+        for (auto && index : revealed)
+        {
+            m_delta.changes.push_back(Delta::Change{m_play_board.coord(index), m_play_board[index]});
+        }
+    }
+    m_revealed_count += revealed.size();
+    m_solver.reveal(revealed);
 }
 
 void
 Game::
 check_for_win()
 {
-    // We won if the only hidden cells left are mines.
-    std::size_t hidden_count = 0;
-    for (std::size_t i = 0; i != m_play_board.rows(); ++i)
+    Metrics::Timer timer{&Metrics::win_check};
+
+    // We won if the only cells not revealed are mines.
+    if (m_revealed_count == safe_count())
     {
-        for (std::size_t j = 0; j != m_play_board.rows(); ++j)
-        {
-            if (m_play_board.at(i, j) == Cell::Hidden
-                or m_play_board.at(i, j) == Cell::Flagged
-                )
-            {
-                ++hidden_count;
-            }
-        }
+        m_result = Result::Won;
     }
-    if (hidden_count == m_mine_coords.size())
+}
+
+void
+Game::
+handle_flag_cmd(Command const & a_command, std::ostream & a_os)
+{
+    if (not a_command.valid)
     {
-        m_result = Result::Won;
+        a_os << "usage: " << flag_cmd_usage() << '\n';
+        return;
+    }
+
+    if (not m_play_board.is_valid(a_command.coord))
+    {
+        write_invalid_coord(a_command.coord, a_os);
+        return;
     }
+
+    toggle_flag(a_command.coord);
+    m_renderer.write(m_play_board, a_os);
 }
 
 void
 Game::
-handle_flag_cmd(std::vector<std::string> const & a_words, std::ostream & a_os)
+handle_chord_cmd(Command const & a_command, std::ostream & a_os)
 {
-    auto write_usage = [&a_os]()
-        {
-            a_os << "usage: " << flag_cmd_usage() << '\n';
-        };
-    if (a_words.size() != 3)
+    if (not a_command.valid)
     {
-        write_usage();
+        a_os << "usage: " << chord_cmd_usage() << '\n';
         return;
     }
 
-    try
+    if (not m_play_board.is_valid(a_command.coord))
     {
-        auto row = std::stoi(a_words[1]);
-        auto col = std::stoi(a_words[2]);
-        auto coord = Coord{row, col};
+        write_invalid_coord(a_command.coord, a_os);
+        return;
+    }
 
-        if (m_play_board.at(coord) == Cell::Hidden)
+    if (chord(a_command.coord) != Result::Lost)
+    {
+        m_renderer.write(m_play_board, a_os);
+    }
+}
+
+void
+Game::
+handle_save_cmd(Command const & a_command, std::ostream & a_os)
+{
+    if (not a_command.valid)
+    {
+        a_os << "usage: " << save_cmd_usage() << '\n';
+        return;
+    }
+
+    std::string const path{a_command.path.begin(), a_command.path.end()};
+    if (Snapshot::save(*this, path))
+    {
+        a_os << "Saved game to '" << path << "'" << std::endl;
+    }
+    else
+    {
+        a_os << "Cannot save game to '" << path << "': " << std::strerror(errno) << std::endl;
+    }
+}
+
+void
+Game::
+toggle_flag(Coord const & a_coord)
+{
+    assert(m_play_board.is_valid(a_coord));
+    auto & cell = m_play_board.at(a_coord);
+    if (cell == Cell::Hidden)
+    {
+        cell = Cell::Flagged;
+        --m_hidden_count;
+        ++m_flagged_count;
+        // TODO: Save flagged coords and add command to list them.
+    }
+    else if (cell == Cell::Flagged)
+    {
+        cell = Cell::Hidden;
+        --m_flagged_count;
+        ++m_hidden_count;
+    }
+    else
+    {
+        return;
+    }
+    if (m_recording)
+    {
+        m_delta.changes.push_back(Delta::Change{a_coord, cell});
+    }
+}
+
+Game::Result
+Game::
+chord(Coord const & a_coord)
+{
+    assert(m_play_board.is_valid(a_coord));
+    auto const index = m_play_board.index(a_coord);
+    auto const cell = m_play_board[index];
+    if (cell < Cell::One or cell > Cell::Eight)
+    {
+        return m_result;
+    }
+
+    auto && deltas = m_play_board.neighbors();
+    auto const flags = std::count_if(std::begin(deltas), std::end(deltas),
+        [this, index](std::ptrdiff_t a_delta) { return m_play_board[index + a_delta] == Cell::Flagged; });
+    if (flags != static_cast<std::int8_t>(cell))
+    {
+        return m_result;
+    }
+
+    // A hidden neighbor with a mine means a flag is wrong.
+    for (auto && delta : deltas)
+    {
+        auto const neighbor = index + delta;
+        if (m_play_board[neighbor] == Cell::Hidden and m_real_board[neighbor] == Cell::Mine)
+        {
+            m_result = Result::Lost;
+            return m_result;
+        }
+    }
+
+    // Neighbors revealed by an earlier neighbor's flood fill are skipped.
+    for (auto && delta : deltas)
+    {
+        auto const neighbor = index + delta;
+        if (m_play_board[neighbor] == Cell::Hidden)
+        {
+            show_more_board(m_play_board.coord(neighbor));
+        }
+    }
+    check_for_win();
+    return m_result;
+}
+
+bool
+Game::
+find_safe(Coord & a_coord)
+{
+    // Only solve when the cells found by the last solve are used up.
+    std::size_t index = 0;
+    if (not m_solver.next_safe(m_play_board, index))
+    {
+        m_solver.solve(m_play_board);
+        if (not m_solver.next_safe(m_play_board, index))
         {
-            m_play_board.at(coord) = Cell::Flagged;
-            // TODO: Save flagged coords and add command to list them.
+            return false;
         }
-        else if (m_play_board.at(coord) == Cell::Flagged)
+    }
+    a_coord = m_play_board.coord(index);
+    return true;
+}
+
+std::size_t
+Game::
+autoplay()
+{
+    auto const revealed_count = m_revealed_count;
+
+    Coord coord{};
+    while (m_result == Result::None and find_safe(coord))
+    {
+        select(coord);
+    }
+
+    // Flag the mines found since the last autoplay.
+    auto && mines = m_solver.mines();
+    for (; m_flagged_known_mines != mines.size(); ++m_flagged_known_mines)
+    {
+        auto const index = mines[m_flagged_known_mines];
+        if (m_play_board[index] == Cell::Hidden)
         {
-            m_play_board.at(coord) = Cell::Hidden;
+            toggle_flag(m_play_board.coord(index));
         }
-        a_os << m_play_board;
     }
-    catch (...)
+
+    return m_revealed_count - revealed_count;
+}
+
+void
+Game::
+handle_auto_cmd(std::ostream & a_os)
+{
+    auto const revealed_count = autoplay();
+    m_renderer.write(m_play_board, a_os);
+    if (revealed_count == 0 and m_result == Result::None)
     {
-        write_usage();
+        a_os << "No squares are certainly safe: select a square to guess" << std::endl;
     }
 }
 
+void
+Game::
+write_invalid_coord(Coord const & a_coord, std::ostream & a_os) const
+{
+    auto max_row = static_cast<std::int64_t>(m_real_board.rows() - 1);
+    auto max_col = static_cast<std::int64_t>(m_real_board.cols() - 1);
+    a_os << "Coordinate " << a_coord << " is invalid"
+        << ": Select a coordinate from " << Coord{0, 0} << " to " << Coord{max_row, max_col}
+        << std::endl;
+}
+
 std::string
 Game::
 select_cmd_usage()
@@ -380,18 +685,61 @@ flag_cmd_usage()
     return "flag <row> <col>";
 }
 
+std::string
+Game::
+chord_cmd_usage()
+{
+    return "chord <row> <col>";
+}
+
+std::string
+Game::
+save_cmd_usage()
+{
+    return "save <file>";
+}
+
+std::size_t
+Game::
+difficulty() const
+{
+    return BoardAnalyzer{}.analyze(m_real_board).three_bv();
+}
+
 std::ostream &
 Game::
 write(std::ostream & a_os) const
 {
     a_os << m_real_board;
 
+    a_os << "seed=" << m_seed << std::endl;
     a_os << "=== Mines ===" << std::endl;
-    for (auto && mine : m_mine_coords)
+    a_os << m_mines;
+
+    return a_os;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, Game::Result a_result)
+{
+    switch (a_result)
     {
-        a_os << mine << std::endl;
-    }
+        case Game::Result::None:
+            a_os << "None";
+            break;
+
+        case Game::Result::Won:
+            a_os << "Won";
+            break;
 
+        case Game::Result::Lost:
+            a_os << "Lost";
+            break;
+
+        case Game::Result::Quit:
+            a_os << "Quit";
+            break;
+    }
     return a_os;
 }
 
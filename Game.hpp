@@ -1,16 +1,23 @@
 #pragma once
 
 #include "Board.hpp"
+#include "BoardAnalysis.hpp"
 #include "Cell.hpp"
+#include "Command.hpp"
 #include "Coord.hpp"
+#include "FloodFill.hpp"
+#include "MineField.hpp"
+#include "Random.hpp"
+#include "Recorder.hpp"
+#include "Renderer.hpp"
 #include "Settings.hpp"
+#include "Solver.hpp"
 
 #include <cassert>
 #include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <vector>
-#include <unordered_set>
 
 namespace wade {
 
@@ -28,41 +35,153 @@ public:
         Quit,
     };
 
+    // Changes made by one step: the result after it and each cell of the play board it changed.
+    struct Delta
+    {
+        struct Change
+        {
+            Coord coord = {};
+            Cell cell = Cell::Hidden; // New value.
+        };
+        using Changes = std::vector<Change>;
+
+        Result result = Result::None;
+        Changes changes = {};
+        bool valid = true; // False if the command could not be applied, e.g. for a coordinate off the board.
+        bool needs_guessing = false; // Set by the select that placed no-guess mines, if they may need a guess.
+    };
+
     Game(Settings const &);
 
+    // Start a new game on the same size board, reusing its buffers; seed 0 picks a new random seed.
+    // With no_guess settings, the mines are placed on the first select.
+    void restart(Random::Seed);
+
+    // Start the game over with the given mines, keeping the seed.
+    void place_mines(MineField const &);
+
     Result play(std::istream &, std::ostream &);
     Result result() const { return m_result; }
 
+    // Run one command the way play does, writing its output. Return false once the game is over.
+    bool execute(Command const & a_command, std::ostream & a_os) { return handle_cmd(a_command, a_os); }
+
+    // Write what play shows before the first command, and after the game is over.
+    void write_intro(std::ostream &);
+    void write_outcome(std::ostream &);
+
+    // Apply a command without reading or writing text, and get what it changed.
+    // The delta is reused by the next step, so each step costs only the cells it changes.
+    Delta const & step(Command const &);
+
+    // Select a valid cell, revealing it and, if it is empty, the area around it.
+    Result select(Coord const &);
+
+    // Select every hidden neighbor of a revealed number whose adjacent mines are all flagged.
+    // Does nothing if the cell is not a number or its flags do not match it; loses if a flag was wrong.
+    Result chord(Coord const &);
+
+    // Flag a hidden cell as a suspected mine, or unflag a flagged cell.
+    void toggle_flag(Coord const &);
+
+    // Find a hidden cell that is certainly safe, judging only from what the player can see.
+    // Return false if there is none.
+    bool find_safe(Coord &);
+
+    // Select every cell that is certainly safe and flag every cell that is certainly a mine, until none are left.
+    // Return number of cells revealed.
+    std::size_t autoplay();
+
+    // Determine if the cells the player can see prove a cell is a mine.
+    bool is_known_mine(Coord const & a_coord) const { return m_solver.is_mine(m_play_board.index(a_coord)); }
+    Solver const & solver() const { return m_solver; }
+
+    // Get settings, the board the player sees and the real board with the mines shown.
+    Settings const & settings() const { return m_settings; }
+    Board const & play_board() const { return m_play_board; }
+    Board const & real_board() const { return m_real_board; }
+
+    // Record every command applied from now on, by play or step, starting with the game's header; null stops.
+    // The recorder must outlive the game or be replaced first.
+    void set_recorder(Recorder *);
+
+    // Get renderer that draws the boards written by play.
+    Renderer & renderer() { return m_renderer; }
+
+    // Get seed the mines were placed with; a game with the same settings and seed has the same board.
+    Random::Seed seed() const { return m_seed; }
+
+    // Determine if no-guess mines were placed from a failed attempt, as no board that needs no guessing was found.
+    bool needs_guessing() const { return m_needs_guessing; }
+
+    // Get counts of cells on the play board, kept up to date by each command.
+    std::size_t hidden_count() const { return m_hidden_count; } // Hidden and not flagged.
+    std::size_t flagged_count() const { return m_flagged_count; }
+    std::size_t revealed_count() const { return m_revealed_count; } // Revealed cells, which are never mines.
+    std::size_t mine_count() const { return m_mines.count(); }
+    std::size_t safe_count() const { return (m_real_board.rows() * m_real_board.cols()) - mine_count(); }
+
+    // Get number of selects, flags, chords and autoplays applied by play or step since the game started.
+    std::size_t clicks() const { return m_clicks; }
+
+    // Get 3BV of the board: the clicks needed to clear it without flags or chords.
+    std::size_t difficulty() const;
+
     std::ostream & write(std::ostream &) const;
 
 protected:
 
     void make_mines(std::size_t a_mines);
+    void make_no_guess_mines(Coord const & a_first);
     void count_adjacent_mines();
+    void hide_board();
 
-    bool handle_cmd(std::vector<std::string> const &, std::ostream &);
+    bool handle_cmd(Command const &, std::ostream &);
     void handle_help_cmd(std::ostream &);
-    void handle_select_cmd(std::vector<std::string> const &, std::ostream &);
+    void handle_select_cmd(Command const &, std::ostream &);
     void show_more_board(Coord const &);
     void check_for_win();
-    void handle_flag_cmd(std::vector<std::string> const &, std::ostream &);
+    void handle_flag_cmd(Command const &, std::ostream &);
+    void handle_chord_cmd(Command const &, std::ostream &);
+    void handle_save_cmd(Command const &, std::ostream &);
+    void handle_auto_cmd(std::ostream &);
+    void write_invalid_coord(Coord const &, std::ostream &) const;
+    bool is_applicable(Command const &) const; // Known command, with a coordinate on the board if it takes one.
+    void apply(Command const &); // Record and count an applicable command about to be run.
 
     static std::string select_cmd_usage();
     static std::string flag_cmd_usage();
-
-    using Coords = std::vector<Coord>;
-    static Coords offsets();
+    static std::string chord_cmd_usage();
+    static std::string save_cmd_usage();
 
 private:
 
+    friend class Snapshot; // Saves and restores the state below in bulk.
+
+    Settings m_settings;
     Board m_real_board; // Real board with mines shown.
     Board m_play_board; // Play board that player sees.
+    MineField m_mines; // Mine positions packed as bits.
+    FloodFill m_flood_fill; // Reused to reveal cells on each select.
+    Solver m_solver; // Told about every reveal; solves only when asked.
+    Renderer m_renderer = {}; // Draws boards for play, keeping the last frame for incremental drawing.
+    std::size_t m_flagged_known_mines = 0; // Mines found by the solver that autoplay has flagged.
+    bool m_mines_pending = false; // No-guess mines wait for the first select.
+    bool m_needs_guessing = false; // No-guess mines could not be made to need no guessing.
+    Random::Seed m_seed = 0;
+    Recorder * m_recorder = nullptr;
+    Delta m_delta = {}; // Changes made by the current step.
+    bool m_recording = false; // Record changes in m_delta while a step runs.
     Result m_result = Result::None;
 
-    using CoordSet = std::unordered_set<Coord>;
-    CoordSet m_mine_coords = {};
+    // Cell counters: hidden + flagged + revealed is always the number of cells on the board.
+    std::size_t m_hidden_count = 0;
+    std::size_t m_flagged_count = 0;
+    std::size_t m_revealed_count = 0;
+    std::size_t m_clicks = 0;
 };
 
+std::ostream & operator<<(std::ostream &, Game::Result);
 std::ostream & operator<<(std::ostream &, Game const &);
 
 }
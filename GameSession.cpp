@@ -3,6 +3,8 @@
 #include "Game.hpp"
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <ostream>
 #include <iostream>
 
@@ -13,14 +15,19 @@ GameSession::
 play(std::istream & a_is, std::ostream & a_os)
 {
     Game game{m_settings};
+    game.renderer().set_mode(m_render_mode);
+    game.set_recorder(m_recorder);
+    auto const start = std::chrono::steady_clock::now();
     auto const result = game.play(a_is, a_os);
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    auto const duration = static_cast<std::uint64_t>(elapsed.count());
     if (result == Game::Result::Won)
     {
-        ++m_stats.wins;
+        m_stats.add_win(duration, game.clicks(), game.difficulty());
     }
-    else if (result == Game::Result::Won)
+    else if (result == Game::Result::Lost)
     {
-        ++m_stats.losses;
+        m_stats.add_loss(duration, game.clicks());
     }
     // TODO: Ask to play again
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Recorder.hpp"
+#include "Renderer.hpp"
 #include "Settings.hpp"
 #include "Stats.hpp"
 
@@ -13,7 +15,14 @@ namespace wade {
 class GameSession
 {
 public:
-    GameSession() = default;
+    GameSession(Settings const & a_settings = Settings{9, 9, 10}, Renderer::Mode a_render_mode = Renderer::Mode::Full)
+        : m_settings{a_settings}
+        , m_render_mode{a_render_mode}
+    {
+    }
+
+    // Record the games played from now on; null stops.
+    void set_recorder(Recorder * a_recorder) { m_recorder = a_recorder; }
 
     void play(std::istream &, std::ostream &);
 
@@ -21,8 +30,10 @@ public:
 
 private:
 
-    Settings m_settings = Settings{9, 9, 10}; // Default to 9x9 board with 10 mines.
+    Settings m_settings; // Default to 9x9 board with 10 mines.
     Stats m_stats = {};
+    Renderer::Mode m_render_mode;
+    Recorder * m_recorder = nullptr;
 };
 
 std::ostream & operator<<(std::ostream &, GameSession const &);
@@ -0,0 +1,203 @@
+#include "Generator.hpp"
+
+#include "Game.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace wade {
+
+constexpr std::size_t Generator::max_attempts;
+constexpr std::size_t Generator::max_repairs;
+
+Generator::
+Generator(Settings const & a_settings, ThreadPool * a_pool)
+    : m_settings{a_settings}
+    , m_pool{a_pool}
+{
+    // Attempts are played on ordinary games with the mines placed by the generator.
+    m_settings.no_guess = false;
+    m_settings.seed = 1;
+}
+
+bool
+Generator::
+generate(Coord const & a_first, Random::Seed a_seed, MineField & a_mines)
+{
+    assert(a_mines.rows() == m_settings.rows and a_mines.cols() == m_settings.cols);
+    m_attempts = 0;
+
+    // Run attempts in rounds of a few per worker, and stop after the first round with a success. Taking the lowest
+    // successful attempt in the round makes the result independent of which worker finished first. Each worker has
+    // its own game and mines, indexed by its number in the pool.
+    auto const workers = m_pool ? m_pool->size() : 1;
+    auto const round_size = 2 * workers;
+    std::vector<std::unique_ptr<Game>> games(workers);
+    std::vector<MineField> mines(workers, a_mines);
+
+    for (std::size_t first_attempt = 0; first_attempt < max_attempts; first_attempt += round_size)
+    {
+        auto const count = std::min(round_size, max_attempts - first_attempt);
+        std::atomic<std::size_t> best{max_attempts};
+        auto const run =
+            [&, this](std::size_t a_index, std::size_t a_worker)
+            {
+                // Skip attempts that can no longer win.
+                auto const attempt_number = first_attempt + a_index;
+                if (attempt_number > best.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                assert(a_worker < workers);
+                if (not games[a_worker])
+                {
+                    games[a_worker].reset(new Game{m_settings});
+                }
+                if (attempt(attempt_number, a_first, a_seed, *games[a_worker], mines[a_worker]))
+                {
+                    auto current = best.load(std::memory_order_relaxed);
+                    while (attempt_number < current and not best.compare_exchange_weak(current, attempt_number)) {}
+                }
+            };
+
+        if (m_pool)
+        {
+            m_pool->parallel_for(count, run);
+        }
+        else
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                run(i, 0);
+            }
+        }
+        m_attempts += count;
+
+        // Play the winning attempt again to get its mines; attempts depend only on their number and the seed.
+        // Any worker may have run no attempt, so replay on a game of our own.
+        if (best != max_attempts)
+        {
+            Game game{m_settings};
+            auto success = attempt(best, a_first, a_seed, game, a_mines);
+            assert(success);
+            return success;
+        }
+    }
+
+    // Give up and keep the last attempt's board.
+    Game game{m_settings};
+    attempt(max_attempts - 1, a_first, a_seed, game, a_mines);
+    return false;
+}
+
+bool
+Generator::
+attempt(std::size_t a_attempt, Coord const & a_first, Random::Seed a_seed, Game & a_game, MineField & a_mines) const
+{
+    std::uint64_t state = a_seed + a_attempt;
+    Random random{Random::mix(state)};
+
+    auto const cells = m_settings.rows * m_settings.cols;
+    auto const excluded_cells = excluded(a_game.play_board(), a_first);
+    a_mines.place(std::min(m_settings.mines, cells - excluded_cells.size()), random, excluded_cells);
+
+    for (std::size_t repairs = 0; ; ++repairs)
+    {
+        a_game.place_mines(a_mines);
+        a_game.select(a_first);
+        a_game.autoplay();
+        if (a_game.result() == Game::Result::Won)
+        {
+            return true;
+        }
+        if (repairs == max_repairs or not repair(a_game, a_first, random, a_mines))
+        {
+            return false;
+        }
+    }
+}
+
+bool
+Generator::
+repair(Game & a_game, Coord const & a_first, Random & a_random, MineField & a_mines) const
+{
+    auto && board = a_game.play_board();
+    auto && deltas = board.neighbors();
+
+    auto is_revealed = [](Cell a_cell) { return a_cell >= Cell::Zero and a_cell <= Cell::Eight; };
+    auto next_to_revealed =
+        [&board, &deltas, &is_revealed](std::size_t a_index)
+        {
+            return std::any_of(std::begin(deltas), std::end(deltas),
+                [&board, &is_revealed, a_index](std::ptrdiff_t a_delta) { return is_revealed(board[a_index + a_delta]); });
+        };
+
+    // Move an unproven mine from the edge of the revealed area, where the solver got stuck, to a cell away from it.
+    // The first selection and its neighbors stay clear so the board still opens the same way.
+    auto const excluded_cells = excluded(board, a_first);
+    std::vector<Coord> stuck{};
+    std::vector<Coord> destinations{};
+    for (std::size_t i = 0; i != board.rows(); ++i)
+    {
+        for (std::size_t j = 0; j != board.cols(); ++j)
+        {
+            auto const index = board.index(i, j);
+            auto const coord = board.coord(index);
+            if (is_revealed(board[index]) or a_game.is_known_mine(coord))
+            {
+                continue;
+            }
+            if (next_to_revealed(index))
+            {
+                if (a_mines.is_mine(i, j))
+                {
+                    stuck.push_back(coord);
+                }
+            }
+            else if (not a_mines.is_mine(i, j)
+                and not std::binary_search(excluded_cells.begin(), excluded_cells.end(), i * board.cols() + j)
+                )
+            {
+                destinations.push_back(coord);
+            }
+        }
+    }
+    if (stuck.empty() or destinations.empty())
+    {
+        return false;
+    }
+
+    auto const from = stuck[a_random.uniform(stuck.size())];
+    auto const to = destinations[a_random.uniform(destinations.size())];
+    a_mines.remove(from.row, from.col);
+    a_mines.add(to.row, to.col);
+    return true;
+}
+
+MineField::CellIndices
+Generator::
+excluded(Board const & a_board, Coord const & a_first) const
+{
+    // Keep the first selection and, if there is room for the mines, its neighbors clear so it opens an area.
+    auto const cells = m_settings.rows * m_settings.cols;
+    auto cell_index =
+        [&a_board](Coord const & a_coord)
+        {
+            return static_cast<std::size_t>(a_coord.row) * a_board.cols() + static_cast<std::size_t>(a_coord.col);
+        };
+    MineField::CellIndices result{cell_index(a_first)};
+    a_board.for_each_neighbor(a_first,
+        [&a_board, &result, &cell_index](std::size_t a_index) { result.push_back(cell_index(a_board.coord(a_index))); });
+    std::sort(result.begin(), result.end());
+    if (m_settings.mines > cells - result.size())
+    {
+        result.assign(1, cell_index(a_first));
+    }
+    return result;
+}
+
+}
+
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Coord.hpp"
+#include "MineField.hpp"
+#include "Random.hpp"
+#include "Settings.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+
+namespace wade {
+
+class Game;
+
+// Makes boards that can be solved without guessing, starting from a given first selection.
+//
+// Each attempt places mines at random away from the first selection and plays the board with the solver. When the
+// solver gets stuck, a mine next to the revealed area is moved to a cell away from it and the board is played again,
+// which often fixes the board without starting over. Attempts run speculatively on all workers of the thread pool,
+// and the lowest-numbered success wins, so the board depends only on the seed.
+class Generator
+{
+public:
+    // Ctors. Without a thread pool, attempts run one at a time on the calling thread.
+    Generator(Settings const &, ThreadPool * = nullptr);
+
+    // Place mines for a board that can be solved after selecting a_first. Return false if no attempt succeeded,
+    // in which case the mines are from the last attempt, which still keeps a_first safe.
+    bool generate(Coord const & a_first, Random::Seed, MineField &);
+
+    // Get number of attempts started by the last generate, including ones run speculatively and thrown away.
+    std::size_t attempts() const { return m_attempts; }
+
+    static constexpr std::size_t max_attempts = 1000;
+    static constexpr std::size_t max_repairs = 64; // Mine moves per attempt.
+
+private:
+
+    bool attempt(std::size_t a_attempt, Coord const & a_first, Random::Seed, Game &, MineField &) const;
+    bool repair(Game &, Coord const & a_first, Random &, MineField &) const;
+    MineField::CellIndices excluded(Board const &, Coord const & a_first) const;
+
+    Settings m_settings;
+    ThreadPool * m_pool = nullptr;
+    std::size_t m_attempts = 0;
+};
+
+}
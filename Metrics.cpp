@@ -0,0 +1,161 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace wade {
+
+void
+Histogram::
+record(std::uint64_t a_value)
+{
+    m_buckets[Sketch::bucket(a_value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(a_value, std::memory_order_relaxed);
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (max < a_value and not m_max.compare_exchange_weak(max, a_value, std::memory_order_relaxed))
+    {
+    }
+}
+
+double
+Histogram::
+mean() const
+{
+    auto const count = this->count();
+    return (count != 0) ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0;
+}
+
+std::uint64_t
+Histogram::
+percentile(double a_fraction) const
+{
+    // Count from the buckets themselves, so that the total matches what the walk below sees.
+    std::uint64_t total = 0;
+    for (auto && count : m_buckets)
+    {
+        total += count.load(std::memory_order_relaxed);
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    auto const rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(a_fraction * total)));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b != m_buckets.size(); ++b)
+    {
+        seen += m_buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(Sketch::highest(b), max());
+        }
+    }
+    return max();
+}
+
+std::ostream &
+Histogram::
+write(std::ostream & a_os) const
+{
+    a_os << "{\"count\":" << count()
+        << ",\"mean\":" << mean()
+        << ",\"p50\":" << percentile(0.5)
+        << ",\"p90\":" << percentile(0.9)
+        << ",\"p99\":" << percentile(0.99)
+        << ",\"p999\":" << percentile(0.999)
+        << ",\"max\":" << max()
+        << '}';
+    return a_os;
+}
+
+#if WADE_METRICS
+thread_local bool Metrics::Scope::s_active = false;
+#endif
+
+Metrics &
+Metrics::
+global()
+{
+    static Metrics metrics{};
+    return metrics;
+}
+
+std::ostream &
+Metrics::
+write(std::ostream & a_os) const
+{
+    auto const now = std::chrono::system_clock::now().time_since_epoch();
+    a_os << "{\"time_ms\":" << std::chrono::duration_cast<std::chrono::milliseconds>(now).count()
+        << ",\"enabled\":" << (WADE_METRICS ? "true" : "false");
+
+    a_os << ",\"commands\":{";
+    char const * separator = "";
+    for (std::size_t t = 0; t != commands.size(); ++t)
+    {
+        if (commands[t].count() != 0)
+        {
+            a_os << separator << '"' << static_cast<Command::Type>(t) << "\":";
+            commands[t].write(a_os);
+            separator = ",";
+        }
+    }
+    a_os << '}';
+
+    auto write_histogram =
+        [&a_os](char const * a_name, Histogram const & a_histogram)
+        {
+            if (a_histogram.count() != 0)
+            {
+                a_os << ",\"" << a_name << "\":";
+                a_histogram.write(a_os);
+            }
+        };
+    write_histogram("generate", generate);
+    write_histogram("flood_fill", flood_fill);
+    write_histogram("win_check", win_check);
+    write_histogram("render", render);
+    write_histogram("revealed", revealed);
+    write_histogram("frontier", frontier);
+    write_histogram("render_bytes", render_bytes);
+    a_os << '}';
+    return a_os;
+}
+
+MetricsDump::
+MetricsDump(std::ostream & a_os, std::chrono::milliseconds a_interval)
+    : m_os{a_os}
+    , m_interval{a_interval}
+{
+    // A zero interval would have the thread write without pause.
+    assert(a_interval.count() > 0);
+    m_thread = std::thread{[this]() { run(); }};
+}
+
+MetricsDump::
+~MetricsDump()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_stopping.notify_one();
+    m_thread.join();
+
+    Metrics::global().write(m_os) << std::endl;
+}
+
+void
+MetricsDump::
+run()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (not m_stopping.wait_for(lock, m_interval, [this]() { return m_stop; }))
+    {
+        Metrics::global().write(m_os) << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Command.hpp"
+#include "Sketch.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+
+// Build with -DWADE_METRICS=0 to compile the instrumentation out: the hooks below become empty and the game code
+// that calls them costs nothing extra.
+#ifndef WADE_METRICS
+#define WADE_METRICS 1
+#endif
+
+namespace wade {
+
+// Distribution of 64-bit values with the buckets of a Sketch, kept in atomics instead: recording is a few relaxed
+// atomic adds, so any number of threads can record at once without a lock.
+class Histogram
+{
+public:
+    void record(std::uint64_t);
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // Get a value that at least the given fraction of the recorded values are no greater than, to within the bucket
+    // size. Values recorded while this runs may or may not be counted.
+    std::uint64_t percentile(double a_fraction) const;
+
+    // Write as a JSON object: count, mean, 50th, 90th, 99th and 99.9th percentiles and max.
+    std::ostream & write(std::ostream &) const;
+
+private:
+
+    std::array<std::atomic<std::uint64_t>, Sketch::bucket_count> m_buckets = {};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+// Where the time and work of the games in this process go. Times are in nanoseconds.
+struct Metrics
+{
+    std::array<Histogram, Command::type_count> commands = {}; // Time to run each type of command.
+    Histogram generate = {}; // Time to place mines and count them, including no-guess generation.
+    Histogram flood_fill = {}; // Time of each flood fill.
+    Histogram win_check = {};
+    Histogram render = {}; // Time to draw each frame.
+    Histogram revealed = {}; // Cells revealed by each flood fill.
+    Histogram frontier = {}; // Most spans waiting at once in each flood fill.
+    Histogram render_bytes = {}; // Size of each frame.
+
+    // Get the metrics every game records to.
+    static Metrics & global();
+
+    // Write as one line of JSON: the time, whether metrics are compiled in, and the histograms that have values.
+    std::ostream & write(std::ostream &) const;
+
+    // Record only while a Scope is open on the thread, so games that tools such as the simulator drive directly,
+    // many at once, skip the clock reads and shared counters; commands and new games open one.
+    class Scope
+    {
+    public:
+#if WADE_METRICS
+        Scope() : m_outer{s_active} { s_active = true; }
+        ~Scope() { s_active = m_outer; }
+#else
+        Scope() {}
+#endif
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+
+        static bool active();
+
+    private:
+#if WADE_METRICS
+        static thread_local bool s_active;
+        bool m_outer;
+#endif
+    };
+
+    // Record the time until the end of the enclosing block, within a Scope.
+    class Timer
+    {
+    public:
+#if WADE_METRICS
+        explicit Timer(Histogram Metrics:: * a_histogram)
+            : m_histogram{Scope::active() ? &(global().*a_histogram) : nullptr}
+            , m_start{m_histogram ? Clock::now() : Clock::time_point{}}
+        {
+        }
+        explicit Timer(Command::Type a_type)
+            : m_histogram{&global().commands[static_cast<std::size_t>(a_type)]}
+            , m_start{Clock::now()}
+        {
+        }
+        ~Timer()
+        {
+            if (m_histogram)
+            {
+                auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start);
+                m_histogram->record(static_cast<std::uint64_t>(elapsed.count()));
+            }
+        }
+#else
+        explicit Timer(Histogram Metrics:: *) {}
+        explicit Timer(Command::Type) {}
+#endif
+        Timer(Timer const &) = delete;
+        Timer & operator=(Timer const &) = delete;
+
+    private:
+#if WADE_METRICS
+        using Clock = std::chrono::steady_clock;
+
+        Histogram * m_histogram;
+        Clock::time_point m_start;
+#endif
+    };
+
+    // Record a value, within a Scope.
+    static void record(Histogram Metrics:: * a_histogram, std::uint64_t a_value)
+    {
+#if WADE_METRICS
+        if (Scope::active())
+        {
+            (global().*a_histogram).record(a_value);
+        }
+#else
+        (void)a_histogram;
+        (void)a_value;
+#endif
+    }
+};
+
+inline
+bool
+Metrics::Scope::
+active()
+{
+#if WADE_METRICS
+    return s_active;
+#else
+    return false;
+#endif
+}
+
+// Write the global metrics to a stream every interval, on a thread of its own, and once more when destroyed.
+class MetricsDump
+{
+public:
+    MetricsDump(std::ostream &, std::chrono::milliseconds a_interval);
+    ~MetricsDump();
+
+    MetricsDump(MetricsDump const &) = delete;
+    MetricsDump & operator=(MetricsDump const &) = delete;
+
+private:
+
+    void run();
+
+    std::ostream & m_os;
+    std::chrono::milliseconds m_interval;
+    std::mutex m_mutex = {};
+    std::condition_variable m_stopping = {};
+    bool m_stop = false;
+    std::thread m_thread = {};
+};
+
+}
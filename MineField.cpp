@@ -0,0 +1,387 @@
+#include "MineField.hpp"
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <ostream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace wade {
+
+namespace {
+
+using Word = MineField::Word;
+
+// Spread the 8 bits of a byte into the 8 bytes of a word: bit k becomes byte k (in memory order) set to 1.
+struct SpreadTable
+{
+    SpreadTable()
+    {
+        for (std::size_t b = 0; b != table.size(); ++b)
+        {
+            std::array<unsigned char, 8> bytes{};
+            for (std::size_t k = 0; k != bytes.size(); ++k)
+            {
+                bytes[k] = (b >> k) & 1;
+            }
+            std::memcpy(&table[b], bytes.data(), bytes.size());
+        }
+    }
+
+    Word operator[](std::size_t a_byte) const { return table[a_byte]; }
+
+    std::array<Word, 256> table = {};
+};
+
+SpreadTable const spread{};
+
+// Neighbor counts for 64 cells, bit-sliced: count = b0 + 2 b1 + 4 b2 + 8 b3 for each bit position.
+struct Planes
+{
+    Word b0 = 0;
+    Word b1 = 0;
+    Word b2 = 0;
+    Word b3 = 0;
+};
+
+// Sum the 8 one-bit neighbor inputs for 64 cells at once with carry-save adders.
+template<typename T>
+void
+add_neighbors(T const (&in)[8], T & b0, T & b1, T & b2, T & b3)
+{
+    // Full adders on the first 6 inputs and a half adder on the last 2, each giving a weight-1 sum
+    // and a weight-2 carry.
+    T const x0 = in[0] ^ in[1];
+    T const s0 = x0 ^ in[2];
+    T const c0 = (in[0] & in[1]) | (in[2] & x0);
+    T const x1 = in[3] ^ in[4];
+    T const s1 = x1 ^ in[5];
+    T const c1 = (in[3] & in[4]) | (in[5] & x1);
+    T const s2 = in[6] ^ in[7];
+    T const c2 = in[6] & in[7];
+
+    // Weight-1 column.
+    T const x2 = s0 ^ s1;
+    b0 = x2 ^ s2;
+    T const k0 = (s0 & s1) | (s2 & x2);
+
+    // Weight-2 column.
+    T const x3 = c0 ^ c1;
+    T const t = x3 ^ c2;
+    T const k1 = (c0 & c1) | (c2 & x3);
+    b1 = t ^ k0;
+    T const k2 = t & k0;
+
+    // Weight-4 and weight-8 columns.
+    b2 = k1 ^ k2;
+    b3 = k1 & k2;
+}
+
+// Compute planes for word w from the rows above, at and below the cells.
+Planes
+count_word(Word const * a_up, Word const * a_mid, Word const * a_down, std::size_t w)
+{
+    // West neighbor of bit c is bit c - 1, east neighbor is bit c + 1; the padding words supply the carries.
+    auto west = [](Word const * a_word) { return (a_word[0] << 1) | (a_word[-1] >> 63); };
+    auto east = [](Word const * a_word) { return (a_word[0] >> 1) | (a_word[1] << 63); };
+
+    auto const up = a_up + w;
+    auto const mid = a_mid + w;
+    auto const down = a_down + w;
+    Word const in[8] = {
+          west(up), *up, east(up)
+        , west(mid), east(mid)
+        , west(down), *down, east(down)
+        };
+    Planes planes{};
+    add_neighbors(in, planes.b0, planes.b1, planes.b2, planes.b3);
+    return planes;
+}
+
+#if defined(__AVX2__)
+
+// Compute planes for the 4 words starting at w.
+void
+count_words_avx2(Word const * a_up, Word const * a_mid, Word const * a_down, std::size_t w, Planes (&a_planes)[4])
+{
+    auto load = [](Word const * a_words) { return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(a_words)); };
+    auto west =
+        [&load, w](Word const * a_row)
+        {
+            return _mm256_or_si256(_mm256_slli_epi64(load(a_row + w), 1), _mm256_srli_epi64(load(a_row + w - 1), 63));
+        };
+    auto east =
+        [&load, w](Word const * a_row)
+        {
+            return _mm256_or_si256(_mm256_srli_epi64(load(a_row + w), 1), _mm256_slli_epi64(load(a_row + w + 1), 63));
+        };
+
+    __m256i const in[8] = {
+          west(a_up), load(a_up + w), east(a_up)
+        , west(a_mid), east(a_mid)
+        , west(a_down), load(a_down + w), east(a_down)
+        };
+    __m256i b[4];
+    add_neighbors(in, b[0], b[1], b[2], b[3]);
+
+    alignas(32) Word out[4][4];
+    for (std::size_t k = 0; k != 4; ++k)
+    {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(out[k]), b[k]);
+    }
+    for (std::size_t i = 0; i != 4; ++i)
+    {
+        a_planes[i] = Planes{out[0][i], out[1][i], out[2][i], out[3][i]};
+    }
+}
+
+#endif
+
+// Write up to 64 cells from the planes and the mine word.
+void
+write_cells(Planes const & a_planes, Word a_mines, Cell * a_cells, std::size_t a_count)
+{
+    static_assert(static_cast<unsigned char>(Cell::Mine) == 0xFF, "Cell::Mine must be all ones");
+
+    for (std::size_t g = 0; g * 8 < a_count; ++g)
+    {
+        auto byte = [g](Word a_word) { return static_cast<std::size_t>((a_word >> (g * 8)) & 0xFF); };
+
+        // Counts are at most 8, so the shifted bytes never carry into each other.
+        Word const counts = spread[byte(a_planes.b0)]
+            | (spread[byte(a_planes.b1)] << 1)
+            | (spread[byte(a_planes.b2)] << 2)
+            | (spread[byte(a_planes.b3)] << 3)
+            ;
+        Word const cells = counts | (spread[byte(a_mines)] * 0xFF);
+        std::memcpy(a_cells + g * 8, &cells, std::min<std::size_t>(8, a_count - g * 8));
+    }
+}
+
+}
+
+constexpr std::size_t MineField::word_bits;
+
+MineField::
+MineField(std::size_t a_rows, std::size_t a_cols)
+    : m_rows{a_rows}
+    , m_cols{a_cols}
+    , m_words{(a_cols + word_bits - 1) / word_bits}
+    , m_bits((a_rows + 2) * (m_words + 2), 0)
+{
+    assert(a_rows > 0);
+    assert(a_cols > 0);
+}
+
+MineField::
+MineField(Settings const & a_settings)
+    : MineField{a_settings.rows, a_settings.cols}
+{
+}
+
+bool
+MineField::
+add(std::size_t row, std::size_t col)
+{
+    assert(row < rows() and col < cols());
+    auto & word = row_words(row)[col / word_bits];
+    Word const bit = Word{1} << (col % word_bits);
+    if (word & bit)
+    {
+        return false;
+    }
+    word |= bit;
+    ++m_count;
+    return true;
+}
+
+bool
+MineField::
+remove(std::size_t row, std::size_t col)
+{
+    assert(row < rows() and col < cols());
+    auto & word = row_words(row)[col / word_bits];
+    Word const bit = Word{1} << (col % word_bits);
+    if (not (word & bit))
+    {
+        return false;
+    }
+    word &= ~bit;
+    --m_count;
+    return true;
+}
+
+void
+MineField::
+clear()
+{
+    std::fill(std::begin(m_bits), std::end(m_bits), 0);
+    m_count = 0;
+}
+
+void
+MineField::
+recount()
+{
+    m_count = 0;
+    for (auto && word : m_bits)
+    {
+        m_count += static_cast<std::size_t>(__builtin_popcountll(word));
+    }
+}
+
+bool
+MineField::
+padding_clear() const
+{
+    auto is_clear = [](Word a_word) { return a_word == 0; };
+    if (not std::all_of(std::begin(m_bits), std::begin(m_bits) + stride(), is_clear)
+        or not std::all_of(std::end(m_bits) - stride(), std::end(m_bits), is_clear)
+        )
+    {
+        return false;
+    }
+
+    // Bits of the last word in each row past the last column.
+    auto const used = m_cols % word_bits;
+    Word const past = (used == 0) ? 0 : ~Word{0} << used;
+    for (std::size_t i = 0; i != m_rows; ++i)
+    {
+        auto const words = row_words(static_cast<std::ptrdiff_t>(i));
+        if (words[-1] != 0 or words[m_words] != 0 or (words[m_words - 1] & past) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MineField::
+place(std::size_t a_mines, Random & a_random, CellIndices const & a_excluded)
+{
+    auto const cells = (rows() * cols()) - a_excluded.size();
+    assert(a_mines <= cells);
+    assert(std::is_sorted(std::begin(a_excluded), std::end(a_excluded)));
+
+    clear();
+
+    // Map an index among the allowed cells to a cell index by stepping over the excluded cells before it.
+    auto to_cell =
+        [&a_excluded](std::size_t a_index)
+        {
+            for (auto && excluded : a_excluded)
+            {
+                a_index += (a_index >= excluded) ? 1 : 0;
+            }
+            return a_index;
+        };
+    auto add_cell = [this](std::size_t a_cell) { return add(a_cell / cols(), a_cell % cols()); };
+
+    // For each j in [cells - mines, cells), pick t in [0, j]; if t is already a mine then j cannot be, so use j.
+    // The bound for each pick is known in advance, so picks are drawn a few steps ahead, in the same order, and
+    // their words prefetched; on large boards the words are otherwise a cache miss each.
+    constexpr std::size_t ahead = 16;
+    std::array<std::size_t, ahead> picks{};
+    auto const first = cells - a_mines;
+    auto draw =
+        [this, &a_random, &picks, &to_cell](std::size_t j)
+        {
+            auto const cell = to_cell(static_cast<std::size_t>(a_random.uniform(j + 1)));
+            picks[j % ahead] = cell;
+            __builtin_prefetch(&row_words(static_cast<std::ptrdiff_t>(cell / cols()))[(cell % cols()) / word_bits], 1);
+        };
+    for (auto j = first; j != std::min(cells, first + ahead); ++j)
+    {
+        draw(j);
+    }
+    for (auto j = first; j != cells; ++j)
+    {
+        auto const cell = picks[j % ahead];
+        if (j + ahead < cells)
+        {
+            draw(j + ahead);
+        }
+        if (not add_cell(cell))
+        {
+            add_cell(to_cell(j));
+        }
+    }
+}
+
+void
+MineField::
+count_adjacent(Board & a_board) const
+{
+    assert(a_board.rows() == rows());
+    assert(a_board.cols() == cols());
+
+    // Each band of rows writes only its own cells, and reads the mine planes of the rows just outside it as they
+    // are, so bands can be counted in any order and the board comes out the same as counting row by row.
+    ThreadPool::for_each_band(rows(), cols(),
+        [this, &a_board](std::size_t a_begin, std::size_t a_end)
+        {
+            for (std::size_t i = a_begin; i != a_end; ++i)
+            {
+                count_row(i, a_board.row_data(i));
+            }
+        });
+}
+
+void
+MineField::
+count_row(std::size_t row, Cell * a_cells) const
+{
+    auto const r = static_cast<std::ptrdiff_t>(row);
+    auto const up = row_words(r - 1);
+    auto const mid = row_words(r);
+    auto const down = row_words(r + 1);
+
+    // Row words are indexed from 0 here; index -1 and m_words are the padding words.
+    std::size_t w = 0;
+#if defined(__AVX2__)
+    for (; w + 4 <= m_words; w += 4)
+    {
+        Planes planes[4];
+        count_words_avx2(up, mid, down, w, planes);
+        for (std::size_t k = 0; k != 4; ++k)
+        {
+            auto const col = (w + k) * word_bits;
+            write_cells(planes[k], mid[w + k], a_cells + col, std::min(word_bits, cols() - col));
+        }
+    }
+#endif
+    for (; w != m_words; ++w)
+    {
+        auto const col = w * word_bits;
+        write_cells(count_word(up, mid, down, w), mid[w], a_cells + col, std::min(word_bits, cols() - col));
+    }
+}
+
+std::ostream &
+MineField::
+write(std::ostream & a_os) const
+{
+    for_each(
+        [&a_os](Coord const & a_coord)
+        {
+            a_os << a_coord << std::endl;
+        });
+    return a_os;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, MineField const & a_mine_field)
+{
+    a_mine_field.write(a_os);
+    return a_os;
+}
+
+}
+
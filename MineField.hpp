@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Coord.hpp"
+#include "Random.hpp"
+#include "Settings.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace wade {
+
+// Mine positions packed as one bit per cell, with one bit plane (a run of 64-bit words) per row.
+// Each plane is padded by a zero word on both sides and the planes by a zero plane above and below,
+// so the neighbor-count kernel never needs to check for the edge of the board.
+class MineField
+{
+public:
+    using Word = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    // Ctors.
+    MineField(std::size_t a_rows, std::size_t a_cols);
+    MineField(Settings const &);
+
+    // Get numbers of rows and columns.
+    std::size_t rows() const { return m_rows; }
+    std::size_t cols() const { return m_cols; }
+
+    // Get number of mines.
+    std::size_t count() const { return m_count; }
+
+    // Determine if row and column has a mine.
+    bool is_mine(std::size_t row, std::size_t col) const;
+    bool is_mine(Coord const & a_coord) const { return is_mine(a_coord.row, a_coord.col); }
+
+    // Add or remove a mine. Return false if the cell was already in that state.
+    bool add(std::size_t row, std::size_t col);
+    bool remove(std::size_t row, std::size_t col);
+
+    // Remove all mines.
+    void clear();
+
+    // Access the packed bits, padding included, to save or restore them in bulk. Call recount after writing them.
+    Word const * data() const { return m_bits.data(); }
+    Word * data() { return m_bits.data(); }
+    std::size_t data_size() const { return m_bits.size(); }
+    void recount();
+
+    // Determine if the padding words and the bits past the last column are all clear, as written bits must leave
+    // them for the neighbor counts to be right.
+    bool padding_clear() const;
+
+    // Replace the mines with a_mines mines at random cells, using Floyd's sampling algorithm over cell indices:
+    // exactly one random number per mine at any density. Excluded cells are row-major cell indices in ascending
+    // order; a_mines must leave room for them.
+    using CellIndices = std::vector<std::size_t>;
+    void place(std::size_t a_mines, Random &, CellIndices const & a_excluded = {});
+
+    // Write every cell of the board: Cell::Mine for mines, else the number of adjacent mines.
+    void count_adjacent(Board &) const;
+
+    // Write the cells of one row the same way, to the cols() cells starting at the given one.
+    void count_row(std::size_t row, Cell * a_cells) const;
+
+    // Call function with the Coord of each mine in row-major order.
+    template<typename Function>
+    void for_each(Function &&) const;
+
+    std::ostream & write(std::ostream &) const;
+
+private:
+
+    // Get words (including padding words) in the buffer per row.
+    std::size_t stride() const { return m_words + 2; }
+
+    // Get first word holding the given row, which may be -1 or rows() for the padding planes.
+    Word * row_words(std::ptrdiff_t row)             { return &m_bits[(row + 1) * stride() + 1]; }
+    Word const * row_words(std::ptrdiff_t row) const { return &m_bits[(row + 1) * stride() + 1]; }
+
+    std::size_t m_rows = 0;
+    std::size_t m_cols = 0;
+    std::size_t m_words = 0; // Words per row, excluding padding.
+    std::size_t m_count = 0;
+    std::vector<Word> m_bits = {};
+};
+
+inline
+bool
+MineField::
+is_mine(std::size_t row, std::size_t col) const
+{
+    assert(row < rows() and col < cols());
+    return (row_words(row)[col / word_bits] >> (col % word_bits)) & 1;
+}
+
+template<typename Function>
+void
+MineField::
+for_each(Function && a_function) const
+{
+    for (std::size_t i = 0; i != rows(); ++i)
+    {
+        auto words = row_words(i);
+        for (std::size_t w = 0; w != m_words; ++w)
+        {
+            // Visit set bits from lowest to highest.
+            for (auto word = words[w]; word != 0; word &= word - 1)
+            {
+                auto const j = w * word_bits + static_cast<std::size_t>(__builtin_ctzll(word));
+                a_function(Coord{static_cast<std::int64_t>(i), static_cast<std::int64_t>(j)});
+            }
+        }
+    }
+}
+
+std::ostream & operator<<(std::ostream &, MineField const &);
+
+}
+
@@ -0,0 +1,542 @@
+#include "ProbabilitySolver.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace wade {
+
+constexpr std::size_t ProbabilitySolver::max_exact_cells;
+
+namespace {
+
+std::size_t const none = std::numeric_limits<std::size_t>::max();
+
+bool
+is_number(Cell a_cell)
+{
+    return a_cell >= Cell::One and a_cell <= Cell::Eight;
+}
+
+bool
+is_hidden(Cell a_cell)
+{
+    return a_cell == Cell::Hidden or a_cell == Cell::Flagged;
+}
+
+// Convolve two mine count distributions: ways to place k mines across both. The result is scaled so its largest
+// count is 1, so that convolving many components cannot overflow, and the log of the scale taken out is added to
+// a_log_scale.
+std::vector<double>
+convolve(std::vector<double> const & a, std::vector<double> const & b, double & a_log_scale)
+{
+    std::vector<double> result(a.size() + b.size() - 1, 0.);
+    for (std::size_t i = 0; i != a.size(); ++i)
+    {
+        for (std::size_t j = 0; j != b.size(); ++j)
+        {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    auto const largest = *std::max_element(result.begin(), result.end());
+    if (largest > 0.)
+    {
+        for (auto && count : result)
+        {
+            count /= largest;
+        }
+        a_log_scale += std::log(largest);
+    }
+    return result;
+}
+
+}
+
+std::size_t
+ProbabilitySolver::KeyHash::
+operator()(Key const & a_key) const noexcept
+{
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (auto && value : a_key)
+    {
+        hash = (hash ^ static_cast<std::uint64_t>(value)) * 0x100000001B3ull;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
+ProbabilitySolver::
+ProbabilitySolver(ThreadPool * a_pool)
+    : m_pool{a_pool}
+{
+}
+
+void
+ProbabilitySolver::
+solve(Board const & a_play_board, std::size_t a_mines, Solver const & a_solver)
+{
+    ++m_generation;
+    find_components(a_play_board, a_solver);
+
+    // Reuse the counts of components seen before, and count the others in parallel.
+    std::vector<std::size_t> unsolved{};
+    m_reused_count = 0;
+    for (std::size_t c = 0; c != m_components.size(); ++c)
+    {
+        auto && component = m_components[c];
+        auto entry = m_cache.find(component.key);
+        if (entry != m_cache.end())
+        {
+            entry->second.generation = m_generation;
+            component.solution = &entry->second.solution;
+            ++m_reused_count;
+        }
+        else
+        {
+            unsolved.push_back(c);
+        }
+    }
+
+    std::vector<Solution> solutions(unsolved.size());
+    auto const enumerate_one =
+        [this, &unsolved, &solutions](std::size_t a_index, std::size_t)
+        {
+            auto && component = m_components[unsolved[a_index]];
+            solutions[a_index] = (component.cells.size() <= max_exact_cells) ? enumerate(component)
+                : approximate(component);
+        };
+    if (m_pool)
+    {
+        m_pool->parallel_for(unsolved.size(), enumerate_one);
+    }
+    else
+    {
+        for (std::size_t i = 0; i != unsolved.size(); ++i)
+        {
+            enumerate_one(i, 0);
+        }
+    }
+
+    for (std::size_t i = 0; i != unsolved.size(); ++i)
+    {
+        auto && component = m_components[unsolved[i]];
+        auto && entry = m_cache[component.key];
+        entry.solution = std::move(solutions[i]);
+        entry.generation = m_generation;
+        component.solution = &entry.solution;
+    }
+
+    combine(a_play_board, a_mines, a_solver);
+
+    // Drop components that changed; their cells have new neighbors, so they will not be seen again.
+    for (auto entry = m_cache.begin(); entry != m_cache.end(); )
+    {
+        entry = (entry->second.generation != m_generation) ? m_cache.erase(entry) : std::next(entry);
+    }
+}
+
+std::size_t
+ProbabilitySolver::
+safest(Board const & a_play_board) const
+{
+    auto best = a_play_board.size();
+    for (std::size_t i = 0; i != a_play_board.size(); ++i)
+    {
+        if (a_play_board[i] == Cell::Hidden
+            and (best == a_play_board.size() or m_probabilities[i] < m_probabilities[best])
+            )
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void
+ProbabilitySolver::
+find_components(Board const & a_play_board, Solver const & a_solver)
+{
+    m_components.clear();
+    m_cell_ids.resize(a_play_board.size(), none);
+    m_known_mine_count = 0;
+    m_unknown_count = 0;
+
+    auto && deltas = a_play_board.neighbors();
+
+    // Frontier cells are numbered in the order found, and joined with union-find when a number touches several.
+    std::vector<std::size_t> cells{};
+    std::vector<std::size_t> parents{};
+    auto find =
+        [&parents](std::size_t x)
+        {
+            while (parents[x] != x)
+            {
+                parents[x] = parents[parents[x]];
+                x = parents[x];
+            }
+            return x;
+        };
+
+    // Numbers with unknown neighbors, whose frontier cell ids are stored in number_cells.
+    struct Number
+    {
+        int mines;
+        std::size_t first;
+        std::size_t size;
+    };
+    std::vector<Number> numbers{};
+    std::vector<std::size_t> number_cells{};
+
+    for (std::size_t i = 0; i != a_play_board.size(); ++i)
+    {
+        auto const cell = a_play_board[i];
+        if (is_hidden(cell))
+        {
+            ++(a_solver.is_mine(i) ? m_known_mine_count : m_unknown_count);
+            continue;
+        }
+        if (not is_number(cell))
+        {
+            continue;
+        }
+
+        Number number{static_cast<int>(cell), number_cells.size(), 0};
+        for (auto && delta : deltas)
+        {
+            auto const adj_index = i + delta;
+            if (not is_hidden(a_play_board[adj_index]))
+            {
+                continue;
+            }
+            if (a_solver.is_mine(adj_index))
+            {
+                --number.mines;
+                continue;
+            }
+            if (m_cell_ids[adj_index] == none)
+            {
+                m_cell_ids[adj_index] = cells.size();
+                parents.push_back(cells.size());
+                cells.push_back(adj_index);
+            }
+            number_cells.push_back(m_cell_ids[adj_index]);
+        }
+        number.size = number_cells.size() - number.first;
+        if (number.size == 0)
+        {
+            continue;
+        }
+        numbers.push_back(number);
+        for (std::size_t k = 1; k != number.size; ++k)
+        {
+            parents[find(number_cells[number.first + k])] = find(number_cells[number.first]);
+        }
+    }
+
+    // Gather each component's cells in buffer order, which gives the same key for the same component every time.
+    std::vector<std::size_t> component_of(cells.size(), none);
+    for (std::size_t id = 0; id != cells.size(); ++id)
+    {
+        auto & component = component_of[find(id)];
+        if (component == none)
+        {
+            component = m_components.size();
+            m_components.emplace_back();
+        }
+        m_components[component].cells.push_back(cells[id]);
+    }
+    std::vector<std::size_t> positions(cells.size(), 0);
+    for (auto && component : m_components)
+    {
+        std::sort(component.cells.begin(), component.cells.end());
+        component.key.push_back(static_cast<std::int64_t>(component.cells.size()));
+        for (std::size_t p = 0; p != component.cells.size(); ++p)
+        {
+            positions[m_cell_ids[component.cells[p]]] = p;
+            component.key.push_back(static_cast<std::int64_t>(component.cells[p]));
+        }
+    }
+
+    // Numbers were found in buffer order too.
+    for (auto && number : numbers)
+    {
+        auto && component = m_components[component_of[find(number_cells[number.first])]];
+        Constraint constraint{};
+        constraint.mines = number.mines;
+        for (std::size_t k = 0; k != number.size; ++k)
+        {
+            constraint.cells.push_back(positions[number_cells[number.first + k]]);
+            component.key.push_back(static_cast<std::int64_t>(constraint.cells.back()));
+        }
+        component.key.push_back(-1 - number.mines);
+        component.constraints.push_back(std::move(constraint));
+    }
+
+    // Leave the ids clear for the next solve.
+    for (auto && cell : cells)
+    {
+        m_cell_ids[cell] = none;
+    }
+}
+
+ProbabilitySolver::Solution
+ProbabilitySolver::
+enumerate(Component const & a_component)
+{
+    auto const cell_count = a_component.cells.size();
+    auto const & constraints = a_component.constraints;
+
+    // Numbers touching each cell.
+    std::vector<std::vector<std::size_t>> cell_constraints(cell_count);
+    for (std::size_t c = 0; c != constraints.size(); ++c)
+    {
+        for (auto && cell : constraints[c].cells)
+        {
+            cell_constraints[cell].push_back(c);
+        }
+    }
+
+    // Mines still to place and cells still open for each number.
+    std::vector<int> remaining(constraints.size());
+    std::vector<int> open(constraints.size());
+    for (std::size_t c = 0; c != constraints.size(); ++c)
+    {
+        remaining[c] = constraints[c].mines;
+        open[c] = static_cast<int>(constraints[c].cells.size());
+    }
+
+    Solution solution{};
+    solution.weights.assign(cell_count + 1, 0.);
+    solution.cell_weights.assign((cell_count + 1) * cell_count, 0.);
+
+    // Assign cells in buffer order, so neighboring cells are decided close together and bad branches die early.
+    std::vector<bool> mine(cell_count, false);
+    std::size_t mines = 0;
+    auto assign =
+        [&](std::size_t a_cell, int a_value)
+        {
+            bool valid = true;
+            for (auto && c : cell_constraints[a_cell])
+            {
+                remaining[c] -= a_value;
+                --open[c];
+                valid = valid and remaining[c] >= 0 and remaining[c] <= open[c];
+            }
+            return valid;
+        };
+    auto unassign =
+        [&](std::size_t a_cell, int a_value)
+        {
+            for (auto && c : cell_constraints[a_cell])
+            {
+                remaining[c] += a_value;
+                ++open[c];
+            }
+        };
+
+    std::function<void(std::size_t)> search =
+        [&](std::size_t a_cell)
+        {
+            if (a_cell == cell_count)
+            {
+                solution.weights[mines] += 1.;
+                auto const row = &solution.cell_weights[mines * cell_count];
+                for (std::size_t i = 0; i != cell_count; ++i)
+                {
+                    row[i] += mine[i] ? 1. : 0.;
+                }
+                return;
+            }
+            for (int value = 0; value != 2; ++value)
+            {
+                if (assign(a_cell, value))
+                {
+                    mine[a_cell] = (value == 1);
+                    mines += value;
+                    search(a_cell + 1);
+                    mines -= value;
+                    mine[a_cell] = false;
+                }
+                unassign(a_cell, value);
+            }
+        };
+    search(0);
+
+    // Scale so the counts cannot overflow when combined; only ratios matter.
+    auto const largest = *std::max_element(solution.weights.begin(), solution.weights.end());
+    if (largest > 0.)
+    {
+        for (auto && weight : solution.weights)
+        {
+            weight /= largest;
+        }
+        for (auto && weight : solution.cell_weights)
+        {
+            weight /= largest;
+        }
+    }
+    return solution;
+}
+
+ProbabilitySolver::Solution
+ProbabilitySolver::
+approximate(Component const & a_component)
+{
+    // Give each cell the mean density of the numbers next to it, and take the component to hold the nearest whole
+    // number of mines to the sum of those chances.
+    auto const cell_count = a_component.cells.size();
+    std::vector<double> chances(cell_count, 0.);
+    std::vector<std::size_t> counts(cell_count, 0);
+    for (auto && constraint : a_component.constraints)
+    {
+        auto const density = static_cast<double>(std::max(0, constraint.mines)) / constraint.cells.size();
+        for (auto && cell : constraint.cells)
+        {
+            chances[cell] += density;
+            ++counts[cell];
+        }
+    }
+    double sum = 0.;
+    for (std::size_t i = 0; i != cell_count; ++i)
+    {
+        chances[i] = std::min(1., chances[i] / std::max<std::size_t>(1, counts[i]));
+        sum += chances[i];
+    }
+    auto const mines = std::min(cell_count, static_cast<std::size_t>(std::lround(sum)));
+
+    Solution solution{};
+    solution.weights.assign(cell_count + 1, 0.);
+    solution.cell_weights.assign((cell_count + 1) * cell_count, 0.);
+    solution.weights[mines] = 1.;
+    for (std::size_t i = 0; i != cell_count and sum > 0.; ++i)
+    {
+        solution.cell_weights[mines * cell_count + i] = std::min(1., chances[i] * mines / sum);
+    }
+    return solution;
+}
+
+void
+ProbabilitySolver::
+combine(Board const & a_play_board, std::size_t a_mines, Solver const & a_solver)
+{
+    m_probabilities.assign(a_play_board.size(), 0.);
+
+    // Mines and cells left once known mines and the frontier are set aside.
+    auto const frontier_count = std::accumulate(m_components.begin(), m_components.end(), std::size_t{0},
+        [](std::size_t a_sum, Component const & a_component) { return a_sum + a_component.cells.size(); });
+    auto const mines = static_cast<double>(a_mines) - static_cast<double>(m_known_mine_count);
+    auto const other_count = m_unknown_count - frontier_count;
+
+    // Mine counts of the components before and after each one, each scaled so its largest count is 1, with the log
+    // of the scale taken out.
+    auto const components = m_components.size();
+    std::vector<std::vector<double>> prefix(components + 1, std::vector<double>{1.});
+    std::vector<std::vector<double>> suffix(components + 1, std::vector<double>{1.});
+    std::vector<double> prefix_scale(components + 1, 0.);
+    std::vector<double> suffix_scale(components + 1, 0.);
+    for (std::size_t c = 0; c != components; ++c)
+    {
+        auto const back = components - c - 1;
+        prefix_scale[c + 1] = prefix_scale[c];
+        prefix[c + 1] = convolve(prefix[c], m_components[c].solution->weights, prefix_scale[c + 1]);
+        suffix_scale[back] = suffix_scale[back + 1];
+        suffix[back] = convolve(m_components[back].solution->weights, suffix[back + 1], suffix_scale[back]);
+    }
+    auto const & frontier = prefix[components];
+
+    // Ways to place the mines not on the frontier among the other cells, for each number of frontier mines s, as
+    // logs, then scaled so the largest number of ways to place every mine is 1 and so fits in a double.
+    std::vector<double> others(frontier.size(), 0.);
+    auto log_choose =
+        [](double n, double k) { return std::lgamma(n + 1) - std::lgamma(k + 1) - std::lgamma(n - k + 1); };
+    auto largest = -std::numeric_limits<double>::infinity();
+    for (std::size_t s = 0; s != others.size(); ++s)
+    {
+        auto const rest = mines - static_cast<double>(s);
+        others[s] = (rest < 0 or rest > other_count or frontier[s] <= 0.) ? -std::numeric_limits<double>::infinity()
+            : log_choose(static_cast<double>(other_count), rest);
+        largest = std::max(largest, others[s] + std::log(frontier[s]));
+    }
+    double total = 0.;
+    double other_mines = 0.;
+    for (std::size_t s = 0; s != others.size(); ++s)
+    {
+        others[s] = std::isinf(others[s]) ? 0. : std::exp(others[s] - largest);
+        total += frontier[s] * others[s];
+        other_mines += frontier[s] * others[s] * (mines - static_cast<double>(s));
+    }
+
+    // Known mines are certain.
+    for (std::size_t i = 0; i != a_play_board.size(); ++i)
+    {
+        if (is_hidden(a_play_board[i]) and a_solver.is_mine(i))
+        {
+            m_probabilities[i] = 1.;
+        }
+    }
+
+    // No arrangement fits what the player sees: fall back to spreading the mines evenly.
+    auto const unknown_chance = (m_unknown_count != 0) ? std::max(0., mines) / m_unknown_count : 0.;
+    if (total <= 0.)
+    {
+        for (std::size_t i = 0; i != a_play_board.size(); ++i)
+        {
+            if (is_hidden(a_play_board[i]) and not a_solver.is_mine(i))
+            {
+                m_probabilities[i] = std::min(1., unknown_chance);
+            }
+        }
+        return;
+    }
+
+    // Cells off the frontier all have the same chance.
+    if (other_count != 0)
+    {
+        auto const other_chance = other_mines / total / other_count;
+        for (std::size_t i = 0; i != a_play_board.size(); ++i)
+        {
+            if (is_hidden(a_play_board[i]) and not a_solver.is_mine(i))
+            {
+                m_probabilities[i] = other_chance;
+            }
+        }
+    }
+
+    // Frontier cells: weigh each of the component's arrangements by the ways to complete it everywhere else.
+    for (std::size_t c = 0; c != components; ++c)
+    {
+        auto && component = m_components[c];
+        auto && solution = *component.solution;
+        auto rest_scale = prefix_scale[c] + suffix_scale[c + 1] - prefix_scale[components];
+        auto const rest = convolve(prefix[c], suffix[c + 1], rest_scale);
+        auto const cell_count = component.cells.size();
+
+        // Completions are on the same scale as total once the scales of rest and the whole frontier are put back.
+        std::vector<double> completions(solution.weights.size(), 0.);
+        for (std::size_t k = 0; k != completions.size(); ++k)
+        {
+            for (std::size_t t = 0; t != rest.size() and k + t < others.size(); ++t)
+            {
+                completions[k] += rest[t] * others[k + t];
+            }
+            completions[k] *= std::exp(rest_scale);
+        }
+
+        for (std::size_t i = 0; i != cell_count; ++i)
+        {
+            double weight = 0.;
+            for (std::size_t k = 0; k != completions.size(); ++k)
+            {
+                weight += solution.cell_weights[k * cell_count + i] * completions[k];
+            }
+            m_probabilities[component.cells[i]] = weight / total;
+        }
+    }
+}
+
+}
+
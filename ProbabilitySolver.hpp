@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace wade {
+
+// Computes the exact probability that each hidden cell is a mine, given the numbers the player can see and the
+// total number of mines.
+//
+// Hidden cells next to numbers (the frontier) are split into components that share no numbers. Each component's
+// mine arrangements are counted by backtracking, and the counts are combined with the number of ways to place the
+// remaining mines on the other hidden cells. Components are solved in parallel on the thread pool, and a component's
+// counts are reused by later solves until a cell next to it changes. Counting takes time exponential in a
+// component's size, so components larger than max_exact_cells are estimated from their numbers instead.
+class ProbabilitySolver
+{
+public:
+    using Probabilities = std::vector<double>;
+
+    static constexpr std::size_t max_exact_cells = 48;
+
+    // Ctors. Without a thread pool, components are solved on the calling thread.
+    ProbabilitySolver(ThreadPool * = nullptr);
+
+    // Compute probabilities for a board with the given total number of mines. Mines already known to the solver
+    // are taken as given, which keeps the components small.
+    void solve(Board const & a_play_board, std::size_t a_mines, Solver const &);
+
+    // Get probability from the last solve that a cell is a mine: 0 for revealed cells and 1 for known mines.
+    double probability(std::size_t a_index) const { return m_probabilities[a_index]; }
+    Probabilities const & probabilities() const { return m_probabilities; }
+
+    // Get the Hidden (not flagged) cell least likely to be a mine, or the board's size if there is none.
+    std::size_t safest(Board const & a_play_board) const;
+
+    // Get numbers of components in the last solve and how many of them were reused from earlier solves.
+    std::size_t component_count() const { return m_components.size(); }
+    std::size_t reused_count() const { return m_reused_count; }
+
+private:
+
+    // Mine arrangement counts for a component, scaled so the largest count is 1.
+    struct Solution
+    {
+        std::vector<double> weights = {}; // Arrangements with k mines, at index k.
+        std::vector<double> cell_weights = {}; // Arrangements with k mines and a mine on cell i, at k * cells + i.
+    };
+
+    // Component of the frontier identified by its cells and its numbers' remaining mines.
+    using Key = std::vector<std::int64_t>;
+
+    struct KeyHash
+    {
+        std::size_t operator()(Key const &) const noexcept;
+    };
+
+    struct Constraint
+    {
+        std::vector<std::size_t> cells = {}; // Positions in the component's cell list.
+        int mines = 0;
+    };
+
+    struct Component
+    {
+        std::vector<std::size_t> cells = {}; // Buffer indices, ascending.
+        std::vector<Constraint> constraints = {};
+        Key key = {};
+        Solution const * solution = nullptr;
+    };
+
+    struct CacheEntry
+    {
+        Solution solution = {};
+        std::uint64_t generation = 0; // Last solve the component appeared in.
+    };
+
+    void find_components(Board const &, Solver const &);
+    static Solution enumerate(Component const &);
+    static Solution approximate(Component const &);
+    void combine(Board const &, std::size_t a_mines, Solver const &);
+
+    ThreadPool * m_pool = nullptr;
+    std::vector<Component> m_components = {};
+    std::unordered_map<Key, CacheEntry, KeyHash> m_cache = {};
+    std::uint64_t m_generation = 0;
+    std::size_t m_reused_count = 0;
+
+    std::vector<std::size_t> m_cell_ids = {}; // Frontier cell id for each buffer index while finding components.
+    std::size_t m_known_mine_count = 0; // Hidden cells known to be mines.
+    std::size_t m_unknown_count = 0; // Hidden cells not known to be mines.
+    Probabilities m_probabilities = {};
+};
+
+}
+
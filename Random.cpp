@@ -0,0 +1,33 @@
+#include "Random.hpp"
+
+#include <random>
+
+namespace wade {
+
+Random::
+Random(Seed a_seed)
+{
+    // Expand the seed with splitmix64, which never gives the all-zero state xoshiro must avoid.
+    for (auto && state : m_state)
+    {
+        state = mix(a_seed);
+    }
+}
+
+Random::Seed
+Random::
+make_seed()
+{
+    // Read the entropy source once per thread and derive further seeds from it.
+    thread_local std::uint64_t state = (static_cast<std::uint64_t>(std::random_device{}()) << 32)
+        ^ std::random_device{}();
+
+    Seed seed = 0;
+    while (seed == 0)
+    {
+        seed = mix(state);
+    }
+    return seed;
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace wade {
+
+// Fast seedable pseudo-random number generator (xoshiro256**), seeded through splitmix64.
+// The same seed always produces the same sequence on every platform.
+class Random
+{
+public:
+    using Seed = std::uint64_t;
+
+    // Ctors.
+    Random(Seed);
+
+    // Get next 64 random bits.
+    std::uint64_t next();
+
+    // Get uniformly distributed number in [0, a_bound).
+    std::uint64_t uniform(std::uint64_t a_bound);
+
+    // Get a new nonzero seed from the system's entropy source.
+    static Seed make_seed();
+
+    // Mix a 64-bit value (one splitmix64 step), e.g. to derive independent seeds from a base seed.
+    static std::uint64_t mix(std::uint64_t & a_state);
+
+private:
+
+    std::array<std::uint64_t, 4> m_state = {};
+};
+
+inline
+std::uint64_t
+Random::
+next()
+{
+    auto rotl = [](std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+
+    auto const result = rotl(m_state[1] * 5, 7) * 9;
+    auto const t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotl(m_state[3], 45);
+    return result;
+}
+
+inline
+std::uint64_t
+Random::
+uniform(std::uint64_t a_bound)
+{
+    // Lemire's multiply-and-reject method: unbiased, and almost never divides.
+    auto product = static_cast<unsigned __int128>(next()) * a_bound;
+    auto low = static_cast<std::uint64_t>(product);
+    if (low < a_bound)
+    {
+        auto const threshold = (0 - a_bound) % a_bound;
+        while (low < threshold)
+        {
+            product = static_cast<unsigned __int128>(next()) * a_bound;
+            low = static_cast<std::uint64_t>(product);
+        }
+    }
+    return static_cast<std::uint64_t>(product >> 64);
+}
+
+inline
+std::uint64_t
+Random::
+mix(std::uint64_t & a_state)
+{
+    auto z = (a_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+}
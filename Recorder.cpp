@@ -0,0 +1,68 @@
+#include "Recorder.hpp"
+
+#include "Game.hpp"
+#include "Varint.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <ostream>
+
+namespace wade {
+
+constexpr std::uint64_t Recorder::version;
+char const Recorder::magic[8] = {'M', 'I', 'N', 'E', 'L', 'O', 'G', '\n'};
+
+Recorder::
+Recorder(std::ostream & a_os)
+    : m_os{a_os}
+{
+}
+
+void
+Recorder::
+start(Game const & a_game)
+{
+    auto && settings = a_game.settings();
+    char buffer[sizeof(magic) + 6 * max_varint_size];
+    auto out = std::copy(std::begin(magic), std::end(magic), buffer);
+    out = write_varint(version, out);
+    out = write_varint(settings.rows, out);
+    out = write_varint(settings.cols, out);
+    out = write_varint(settings.mines, out);
+    out = write_varint(settings.no_guess, out);
+    out = write_varint(a_game.seed(), out);
+    m_os.write(buffer, out - buffer);
+    m_last = Clock::now();
+}
+
+void
+Recorder::
+record(Command const & a_command)
+{
+    Code code{};
+    bool has_coord = true;
+    switch (a_command.type)
+    {
+        case Command::Type::Select: code = Code::Select; break;
+        case Command::Type::Flag:   code = Code::Flag; break;
+        case Command::Type::Chord:  code = Code::Chord; break;
+        case Command::Type::Auto:   code = Code::Auto; has_coord = false; break;
+        case Command::Type::Quit:   code = Code::Quit; has_coord = false; break;
+        default: return;
+    }
+
+    auto const now = Clock::now();
+    auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_last).count();
+    m_last = now;
+
+    char buffer[3 * max_varint_size];
+    auto out = write_varint((static_cast<std::uint64_t>(elapsed) << 3) | static_cast<std::uint64_t>(code), buffer);
+    if (has_coord)
+    {
+        out = write_varint(static_cast<std::uint64_t>(a_command.coord.row), out);
+        out = write_varint(static_cast<std::uint64_t>(a_command.coord.col), out);
+    }
+    m_os.write(buffer, out - buffer);
+}
+
+}
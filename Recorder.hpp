@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Command.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+namespace wade {
+
+class Game;
+
+// Append a game's commands to a binary log as they are applied, so the game can be replayed exactly.
+//
+// The log starts with the magic bytes "MINELOG\n" and varints for the format version, rows, columns, mines,
+// no_guess and the seed the mines were placed with. Each command follows as a varint holding the microseconds since
+// the previous one shifted left 3 bits, with the command code in the low bits, then for commands with a coordinate,
+// varints for its row and column.
+class Recorder
+{
+public:
+    static constexpr std::uint64_t version = 1;
+    static char const magic[8];
+
+    // Command codes in the log.
+    enum class Code : std::uint8_t
+    {
+        Select = 0,
+        Flag = 1,
+        Chord = 2,
+        Auto = 3,
+        Quit = 4,
+    };
+
+    // Ctors.
+    Recorder(std::ostream &);
+
+    // Write the header for a game; call before recording its commands.
+    void start(Game const &);
+
+    // Write a command that is being applied to the game. Commands that change nothing are ignored.
+    void record(Command const &);
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    std::ostream & m_os;
+    Clock::time_point m_last = {};
+};
+
+}
@@ -0,0 +1,214 @@
+#include "Renderer.hpp"
+
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ostream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace wade {
+
+namespace {
+
+// Lines of the frame above the first row: the digit border and the top border.
+constexpr std::size_t header_lines = 2;
+
+// Columns of a row before its first cell: the row digit and a separator.
+constexpr std::size_t row_prefix = 2;
+
+// Lines kept free below the board for the prompt, the echoed command and a message written between frames.
+constexpr std::size_t spare_lines = 4;
+
+char const clear_screen[] = "\x1b[H\x1b[2J";
+char const clear_below[] = "\x1b[J";
+
+// Get number of lines of the terminal on standard output, or 0 if it is not a terminal.
+std::size_t
+terminal_lines()
+{
+    winsize size{};
+    if (::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0)
+    {
+        return 0;
+    }
+    return size.ws_row;
+}
+
+}
+
+void
+Renderer::
+write(Board const & a_board, std::ostream & a_os)
+{
+    Metrics::Timer timer{&Metrics::render};
+    m_buffer.clear();
+    auto const lines = (m_mode == Mode::Incremental) ? terminal_lines() : 0;
+    if (m_mode == Mode::Full or (lines != 0 and 2 * header_lines + a_board.rows() + spare_lines > lines))
+    {
+        // Start again from a cleared screen once the board fits.
+        format(a_board, m_buffer);
+        reset();
+    }
+    else if (m_last.empty() or a_board.rows() != m_rows or a_board.cols() != m_cols)
+    {
+        m_buffer += clear_screen;
+        format(a_board, m_buffer);
+        remember(a_board);
+    }
+    else
+    {
+        format_changes(a_board);
+        remember(a_board);
+    }
+    a_os.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    ++m_frames;
+    Metrics::record(&Metrics::render_bytes, m_buffer.size());
+}
+
+void
+Renderer::
+format(Board const & a_board, std::string & a_buffer)
+{
+    auto const rows = a_board.rows();
+    auto const cols = a_board.cols();
+    auto const digit_line = 2 * cols + 3;
+    auto const border_line = 2 * cols + 3;
+    auto const row_line = 2 * cols + 4;
+
+    // Size the buffer once and fill it in place.
+    auto const start = a_buffer.size();
+    a_buffer.resize(start + 2 * digit_line + 2 * border_line + rows * row_line);
+    auto out = &a_buffer[start];
+
+    // Write digits to make it easier to select a cell coordinate.
+    auto write_digit_border =
+        [cols, &out]()
+        {
+            *out++ = ' ';
+            *out++ = ' ';
+            for (std::size_t j = 0; j != cols; ++j)
+            {
+                *out++ = static_cast<char>('0' + j % 10);
+                *out++ = ' ';
+            }
+            *out++ = '\n';
+        };
+    auto write_border =
+        [cols, &out]()
+        {
+            *out++ = ' ';
+            *out++ = '|';
+            out = std::fill_n(out, 2 * cols - 1, '-');
+            *out++ = '|';
+            *out++ = '\n';
+        };
+
+    write_digit_border();
+    write_border();
+    for (std::size_t i = 0; i != rows; ++i)
+    {
+        // Write |cell|
+        auto const digit = static_cast<char>('0' + i % 10);
+        *out++ = digit;
+        *out++ = '|';
+        auto row = a_board.row_data(i);
+        for (std::size_t j = 0; j != cols; ++j)
+        {
+            *out++ = to_char(row[j]);
+            *out++ = '|';
+        }
+        *out++ = digit;
+        *out++ = '\n';
+    }
+    write_border();
+    write_digit_border();
+
+    assert(out == &a_buffer[0] + a_buffer.size());
+}
+
+void
+Renderer::
+format_changes(Board const & a_board)
+{
+    auto const cols = a_board.cols();
+    for (std::size_t i = 0; i != a_board.rows(); ++i)
+    {
+        auto row = a_board.row_data(i);
+        auto last = &m_last[i * cols];
+        if (std::memcmp(row, last, cols * sizeof(Cell)) == 0)
+        {
+            continue;
+        }
+
+        // After drawing a cell the cursor is on the separator before the next, so a run of changed cells needs
+        // only one cursor move.
+        auto next = cols;
+        for (std::size_t j = 0; j != cols; ++j)
+        {
+            if (row[j] == last[j])
+            {
+                continue;
+            }
+            if (j == next)
+            {
+                m_buffer += '|';
+            }
+            else
+            {
+                append_cursor_move(header_lines + i + 1, row_prefix + 2 * j + 1);
+            }
+            m_buffer += to_char(row[j]);
+            next = j + 1;
+        }
+    }
+
+    // Leave the cursor below the board, clearing what was written there after the last frame.
+    append_cursor_move(2 * header_lines + a_board.rows() + 1, 1);
+    m_buffer += clear_below;
+}
+
+void
+Renderer::
+remember(Board const & a_board)
+{
+    m_rows = a_board.rows();
+    m_cols = a_board.cols();
+    m_last.resize(m_rows * m_cols);
+    for (std::size_t i = 0; i != m_rows; ++i)
+    {
+        std::copy_n(a_board.row_data(i), m_cols, &m_last[i * m_cols]);
+    }
+}
+
+void
+Renderer::
+append_cursor_move(std::size_t a_line, std::size_t a_column)
+{
+    // Lines and columns start at 1.
+    m_buffer += "\x1b[";
+    append_number(a_line);
+    m_buffer += ';';
+    append_number(a_column);
+    m_buffer += 'H';
+}
+
+void
+Renderer::
+append_number(std::size_t a_number)
+{
+    char digits[20];
+    auto end = digits + sizeof(digits);
+    auto begin = end;
+    do
+    {
+        *--begin = static_cast<char>('0' + a_number % 10);
+        a_number /= 10;
+    }
+    while (a_number != 0);
+    m_buffer.append(begin, end);
+}
+
+}
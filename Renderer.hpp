@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Cell.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace wade {
+
+// Draw boards for a terminal. Each frame is formatted into a reused buffer and written with a single call.
+//
+// In incremental mode the first frame clears the screen and is drawn at the top; later frames of the same size
+// only move the cursor to the cells that changed since the last frame and redraw those, using ANSI escape codes,
+// then leave the cursor on the line below the board with the rest of the screen cleared. Cursor moves are to lines
+// counted from the top of the screen, so a board too tall to fit the terminal on standard output, which would
+// scroll it, is drawn in full instead, and callers that write more than a prompt and a line or two of text between
+// frames must reset first, so the next frame starts again from a cleared screen.
+class Renderer
+{
+public:
+    enum class Mode
+    {
+        Full, // Write the whole board each frame.
+        Incremental, // Write only the changed cells, as ANSI cursor moves.
+    };
+
+    // Ctors.
+    Renderer(Mode a_mode = Mode::Full) : m_mode{a_mode} {}
+
+    Mode mode() const { return m_mode; }
+    void set_mode(Mode a_mode) { m_mode = a_mode; reset(); }
+
+    // Forget the last frame, so the next one is drawn in full.
+    void reset() { m_last.clear(); }
+
+    // Write a frame for the board.
+    void write(Board const &, std::ostream &);
+
+    // Get number of frames written.
+    std::size_t frames() const { return m_frames; }
+
+    // Append the whole board, with coordinate borders, to the buffer.
+    static void format(Board const &, std::string & a_buffer);
+
+private:
+
+    void format_changes(Board const &);
+    void remember(Board const &);
+    void append_cursor_move(std::size_t a_line, std::size_t a_column);
+    void append_number(std::size_t);
+
+    Mode m_mode;
+    std::string m_buffer = {};
+    std::size_t m_rows = 0;
+    std::size_t m_cols = 0;
+    std::vector<Cell> m_last = {}; // Cells of the last frame, row-major without the border; empty before the first.
+    std::size_t m_frames = 0;
+};
+
+}
@@ -0,0 +1,122 @@
+#include "Replay.hpp"
+
+#include "Recorder.hpp"
+#include "Varint.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace wade {
+
+Replay::
+Replay(std::size_t a_checkpoint_interval)
+    : m_checkpoint_interval{std::max<std::size_t>(a_checkpoint_interval, 1)}
+{
+}
+
+bool
+Replay::
+open(char const * a_begin, char const * a_end)
+{
+    auto pos = a_begin;
+    if (static_cast<std::size_t>(a_end - a_begin) < sizeof(Recorder::magic)
+        or std::memcmp(a_begin, Recorder::magic, sizeof(Recorder::magic)) != 0
+        )
+    {
+        return false;
+    }
+    pos += sizeof(Recorder::magic);
+
+    std::uint64_t version = 0;
+    std::uint64_t no_guess = 0;
+    Settings settings{};
+    if (not read_varint(pos, a_end, version) or version != Recorder::version
+        or not read_varint(pos, a_end, settings.rows)
+        or not read_varint(pos, a_end, settings.cols)
+        or not read_varint(pos, a_end, settings.mines)
+        or not read_varint(pos, a_end, no_guess)
+        or not read_varint(pos, a_end, settings.seed)
+        or settings.rows == 0 or settings.cols == 0
+        )
+    {
+        return false;
+    }
+    settings.no_guess = (no_guess != 0);
+
+    // Decode every move; a move cut off at the end of the log, e.g. by a crash, ends it.
+    Moves moves{};
+    std::uint64_t time = 0;
+    std::uint64_t head = 0;
+    while (read_varint(pos, a_end, head))
+    {
+        Move move{};
+        time += head >> 3;
+        move.time = time;
+        switch (static_cast<Recorder::Code>(head & 7))
+        {
+            case Recorder::Code::Select: move.type = Command::Type::Select; break;
+            case Recorder::Code::Flag:   move.type = Command::Type::Flag; break;
+            case Recorder::Code::Chord:  move.type = Command::Type::Chord; break;
+            case Recorder::Code::Auto:   move.type = Command::Type::Auto; break;
+            case Recorder::Code::Quit:   move.type = Command::Type::Quit; break;
+            default: return false;
+        }
+        if (move.type == Command::Type::Select or move.type == Command::Type::Flag or move.type == Command::Type::Chord)
+        {
+            std::uint64_t row = 0;
+            std::uint64_t col = 0;
+            if (not read_varint(pos, a_end, row) or not read_varint(pos, a_end, col))
+            {
+                break;
+            }
+            if (row >= settings.rows or col >= settings.cols)
+            {
+                return false;
+            }
+            move.coord = Coord{static_cast<std::int64_t>(row), static_cast<std::int64_t>(col)};
+        }
+        moves.push_back(move);
+    }
+
+    m_settings = settings;
+    m_moves = std::move(moves);
+    m_checkpoints.clear();
+    m_game.reset(new Game{m_settings});
+    m_checkpoints.push_back(*m_game);
+    m_position = 0;
+    return true;
+}
+
+void
+Replay::
+seek(std::size_t a_position)
+{
+    assert(m_game);
+    a_position = std::min(a_position, m_moves.size());
+
+    // Go back to the nearest checkpoint if the target is behind us, or if a later checkpoint saves replaying.
+    auto const checkpoint = std::min(a_position / m_checkpoint_interval, m_checkpoints.size() - 1);
+    if (a_position < m_position or checkpoint * m_checkpoint_interval > m_position)
+    {
+        *m_game = m_checkpoints[checkpoint];
+        m_position = checkpoint * m_checkpoint_interval;
+    }
+
+    for (; m_position != a_position; )
+    {
+        auto && move = m_moves[m_position];
+        Command command{};
+        command.type = move.type;
+        command.coord = move.coord;
+        m_game->step(command);
+        ++m_position;
+
+        if (m_position % m_checkpoint_interval == 0 and m_position / m_checkpoint_interval == m_checkpoints.size())
+        {
+            m_checkpoints.push_back(*m_game);
+        }
+    }
+}
+
+}
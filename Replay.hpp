@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Command.hpp"
+#include "Coord.hpp"
+#include "Game.hpp"
+#include "Settings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace wade {
+
+// Play back a log written by Recorder at full speed, without parsing text or drawing boards.
+//
+// Moves are decoded once up front. Playing forward keeps a copy of the game every checkpoint_interval moves, so
+// seeking back to any move only replays from the nearest checkpoint before it.
+class Replay
+{
+public:
+    struct Move
+    {
+        Command::Type type = Command::Type::None;
+        Coord coord = {};
+        std::uint64_t time = 0; // Microseconds since the log started.
+    };
+    using Moves = std::vector<Move>;
+
+    // Ctors.
+    Replay(std::size_t a_checkpoint_interval = 1024);
+
+    // Decode a log and start at move 0. Return false if it is not a log this version can read.
+    bool open(char const * a_begin, char const * a_end);
+
+    // Get settings, with the seed the mines were placed with, and the decoded moves.
+    Settings const & settings() const { return m_settings; }
+    Moves const & moves() const { return m_moves; }
+
+    // Get number of moves played so far, and the game after them.
+    std::size_t position() const { return m_position; }
+    Game const & game() const { return *m_game; }
+
+    // Move to the game after the first a_position moves, or after all of them if there are fewer.
+    void seek(std::size_t a_position);
+
+private:
+
+    std::size_t m_checkpoint_interval;
+    Settings m_settings = {};
+    Moves m_moves = {};
+    std::vector<Game> m_checkpoints = {}; // Game after each multiple of checkpoint_interval moves, from move 0.
+    std::unique_ptr<Game> m_game = {};
+    std::size_t m_position = 0;
+};
+
+}
@@ -0,0 +1,115 @@
+#include "Script.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wade {
+
+namespace {
+
+// Size of each read from a stream that cannot be mapped.
+constexpr std::size_t block_size = 1 << 20;
+
+}
+
+Script::
+~Script()
+{
+    close();
+}
+
+bool
+Script::
+open(std::string const & a_path)
+{
+    close();
+    if (a_path == "-")
+    {
+        return read_all(STDIN_FILENO);
+    }
+
+    auto const fd = ::open(a_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Map regular files; read anything else, such as a pipe, in blocks.
+    struct stat status{};
+    bool ok = (::fstat(fd, &status) == 0);
+    if (ok and S_ISREG(status.st_mode) and status.st_size > 0)
+    {
+        auto const size = static_cast<std::size_t>(status.st_size);
+        auto const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            // The script is read once from start to end.
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            m_mapping = mapping;
+            m_data = static_cast<char const *>(mapping);
+            m_size = size;
+        }
+        else
+        {
+            ok = read_all(fd);
+        }
+    }
+    else if (ok)
+    {
+        ok = read_all(fd);
+    }
+
+    auto const error = errno;
+    ::close(fd);
+    errno = error;
+    return ok;
+}
+
+void
+Script::
+close()
+{
+    if (m_mapping)
+    {
+        ::munmap(m_mapping, m_size);
+        m_mapping = nullptr;
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool
+Script::
+read_all(int a_fd)
+{
+    std::size_t size = 0;
+    while (1)
+    {
+        m_buffer.resize(size + block_size);
+        auto const count = ::read(a_fd, m_buffer.data() + size, block_size);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            m_buffer.clear();
+            return false;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        size += static_cast<std::size_t>(count);
+    }
+    m_buffer.resize(size);
+    m_data = m_buffer.data();
+    m_size = size;
+    return true;
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace wade {
+
+// Read-only contents of a command script: a memory-mapped file, or standard input read in large blocks.
+class Script
+{
+public:
+    // Ctors.
+    Script() = default;
+    ~Script();
+
+    Script(Script const &) = delete;
+    Script & operator=(Script const &) = delete;
+
+    // Load script from a file, or from standard input if the path is "-".
+    // Return false and leave errno set if it cannot be read.
+    bool open(std::string const & a_path);
+
+    // Get the script's characters.
+    char const * begin() const { return m_data; }
+    char const * end() const { return m_data + m_size; }
+    std::size_t size() const { return m_size; }
+
+private:
+
+    void close();
+    bool read_all(int a_fd);
+
+    char const * m_data = nullptr;
+    std::size_t m_size = 0;
+    void * m_mapping = nullptr; // Mapped file, if the script was mapped.
+    std::vector<char> m_buffer = {}; // Script read from a stream that cannot be mapped.
+};
+
+}
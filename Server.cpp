@@ -0,0 +1,530 @@
+#include "Server.hpp"
+
+#include "Random.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace wade {
+
+namespace {
+
+// Tags for the epoll events that are not connections, which are tagged with their file descriptor.
+constexpr std::uint64_t listener_tag = ~std::uint64_t{0};
+constexpr std::uint64_t wakeup_tag = ~std::uint64_t{1};
+
+constexpr int max_events = 256;
+constexpr std::size_t read_size = 64 * 1024;
+
+// Most input kept for a connection. A longer line, or more input queued behind a slow command, drops the client.
+constexpr std::size_t max_input = 1 << 20;
+
+char const prompt[] = "> ";
+
+}
+
+Server::
+Server(Settings const & a_settings, std::size_t a_workers, std::size_t a_heavy_cells)
+    : m_settings{a_settings}
+    , m_heavy_cells{a_heavy_cells}
+{
+    m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = wakeup_tag;
+    ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event);
+
+    for (std::size_t w = 0; w != a_workers; ++w)
+    {
+        m_workers.emplace_back([this]() { run_worker(); });
+    }
+}
+
+Server::
+~Server()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop_workers = true;
+    }
+    m_jobs_ready.notify_all();
+    for (auto && worker : m_workers)
+    {
+        worker.join();
+    }
+
+    for (auto && entry : m_connections)
+    {
+        ::close(entry.first);
+    }
+    if (m_listener >= 0)
+    {
+        ::close(m_listener);
+        ::unlink(m_path.c_str());
+    }
+    ::close(m_wakeup);
+    ::close(m_epoll);
+}
+
+bool
+Server::
+listen(std::string const & a_path)
+{
+    sockaddr_un address{};
+    if (a_path.size() >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, a_path.c_str(), a_path.size() + 1);
+
+    m_listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listener < 0)
+    {
+        return false;
+    }
+    ::unlink(a_path.c_str());
+    if (::bind(m_listener, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0
+        or ::listen(m_listener, SOMAXCONN) != 0
+        )
+    {
+        auto const error = errno;
+        ::close(m_listener);
+        m_listener = -1;
+        errno = error;
+        return false;
+    }
+    m_path = a_path;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = listener_tag;
+    return ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_listener, &event) == 0;
+}
+
+void
+Server::
+run()
+{
+    epoll_event events[max_events];
+    while (not m_stop)
+    {
+        auto const count = ::epoll_wait(m_epoll, events, max_events, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i != count; ++i)
+        {
+            auto const tag = events[i].data.u64;
+            if (tag == listener_tag)
+            {
+                accept_connections();
+                continue;
+            }
+            if (tag == wakeup_tag)
+            {
+                std::uint64_t wakeups = 0;
+                while (::read(m_wakeup, &wakeups, sizeof(wakeups)) > 0) {}
+                finish_jobs();
+                continue;
+            }
+
+            // The connection may have been closed by an earlier event in this batch.
+            auto found = m_connections.find(static_cast<int>(tag));
+            if (found == m_connections.end())
+            {
+                continue;
+            }
+            auto & connection = *found->second;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                read(connection);
+            }
+            if (m_connections.count(static_cast<int>(tag)) and (events[i].events & EPOLLOUT))
+            {
+                flush(connection);
+            }
+        }
+    }
+}
+
+void
+Server::
+stop()
+{
+    m_stop = true;
+    wake();
+}
+
+void
+Server::
+accept_connections()
+{
+    while (1)
+    {
+        auto const fd = ::accept4(m_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // EAGAIN when there are no more; other errors only lose that one connection.
+            if (errno == EINTR or errno == ECONNABORTED)
+            {
+                continue;
+            }
+            return;
+        }
+
+        // With a fixed seed, give each connection its own board derived from it.
+        auto settings = m_settings;
+        if (settings.seed != 0)
+        {
+            std::uint64_t state = m_settings.seed + m_connection_number;
+            settings.seed = Random::mix(state);
+        }
+        ++m_connection_number;
+
+        std::unique_ptr<Connection> connection{new Connection{fd, settings}};
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = static_cast<std::uint64_t>(fd);
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            ::close(fd);
+            continue;
+        }
+
+        auto & added = *(m_connections[fd] = std::move(connection));
+        added.game.write_intro(added.os);
+        added.os << prompt;
+        flush(added);
+    }
+}
+
+void
+Server::
+read(Connection & a_connection)
+{
+    // Once the input has ended, the socket is only watched for output, so the client has gone altogether.
+    if (a_connection.input_done)
+    {
+        hang_up(a_connection);
+        process(a_connection);
+        return;
+    }
+
+    // Read everything available, up to the limit, then run the complete lines. Input past the limit stays in the
+    // socket until the lines before it have run.
+    while (a_connection.input.size() < max_input)
+    {
+        auto const size = a_connection.input.size();
+        a_connection.input.resize(size + read_size);
+        auto const count = ::read(a_connection.fd, &a_connection.input[size], read_size);
+        a_connection.input.resize(size + static_cast<std::size_t>(count > 0 ? count : 0));
+        if (count > 0)
+        {
+            continue;
+        }
+        if (count < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        if (count == 0)
+        {
+            end_input(a_connection);
+        }
+        else if (errno != EAGAIN and errno != EWOULDBLOCK)
+        {
+            hang_up(a_connection);
+        }
+        break;
+    }
+    process(a_connection);
+}
+
+void
+Server::
+process(Connection & a_connection)
+{
+    std::size_t consumed = 0;
+    auto && input = a_connection.input;
+    while (not a_connection.busy and not a_connection.closing and not a_connection.hung_up)
+    {
+        auto const begin = input.data() + consumed;
+        auto const end = input.data() + input.size();
+        auto const newline = static_cast<char const *>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+        if (not newline)
+        {
+            break;
+        }
+        consumed = static_cast<std::size_t>(newline + 1 - input.data());
+        if (not run_line(a_connection, begin, newline))
+        {
+            a_connection.game.write_outcome(a_connection.os);
+            a_connection.closing = true;
+        }
+    }
+    input.erase(0, consumed);
+    if (a_connection.input_done and not a_connection.busy)
+    {
+        // Every line the client sent has run, so end as if it had quit, once the output is sent.
+        a_connection.closing = true;
+    }
+    if (a_connection.closing)
+    {
+        // Commands after the end of the game are ignored.
+        input.clear();
+    }
+    else if (input.size() >= max_input and not a_connection.hung_up)
+    {
+        hang_up(a_connection);
+    }
+    flush(a_connection);
+}
+
+void
+Server::
+end_input(Connection & a_connection)
+{
+    // The client has shut down its side but may still be reading. A last line without a newline still counts, as
+    // it does for the interactive game. Stop watching for input, which would keep reporting the end of it.
+    if (not a_connection.input.empty() and a_connection.input.back() != '\n')
+    {
+        a_connection.input += '\n';
+    }
+    a_connection.input_done = true;
+    watch(a_connection);
+}
+
+void
+Server::
+hang_up(Connection & a_connection)
+{
+    // No one is left to read the output. Stop watching the socket too, as it would keep reporting the end of the
+    // input until a busy connection's job is done and it can be closed.
+    a_connection.hung_up = true;
+    a_connection.input.clear();
+    ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, a_connection.fd, nullptr);
+}
+
+bool
+Server::
+run_line(Connection & a_connection, char const * a_begin, char const * a_end)
+{
+    auto const command = Command::parse(a_begin, a_end);
+    if (command.type == Command::Type::Save)
+    {
+        // Clients may not write files on the server's machine.
+        a_connection.os << "Saving is not available on the server\n" << prompt;
+        return true;
+    }
+    if (is_heavy(a_connection, command))
+    {
+        // The job keeps its own copy of the line, as more input may arrive while it waits.
+        a_connection.busy = true;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_jobs.push_back(Job{&a_connection, std::string{a_begin, a_end}});
+        }
+        m_jobs_ready.notify_one();
+        return true;
+    }
+
+    bool const keep_playing = a_connection.game.execute(command, a_connection.os);
+    if (keep_playing)
+    {
+        a_connection.os << prompt;
+    }
+    return keep_playing;
+}
+
+bool
+Server::
+is_heavy(Connection const & a_connection, Command const & a_command) const
+{
+    // Selects and chords can flood fill the whole board, autoplay can solve it, and a no-guess game's first select
+    // generates it.
+    auto && settings = a_connection.game.settings();
+    if (a_command.type == Command::Type::Auto or a_command.type == Command::Type::Chord)
+    {
+        return settings.rows * settings.cols >= m_heavy_cells;
+    }
+    if (a_command.type == Command::Type::Select)
+    {
+        return settings.no_guess or settings.rows * settings.cols >= m_heavy_cells;
+    }
+    return false;
+}
+
+void
+Server::
+flush(Connection & a_connection)
+{
+    if (a_connection.busy)
+    {
+        return;
+    }
+    if (a_connection.hung_up)
+    {
+        close(a_connection);
+        return;
+    }
+
+    auto && data = a_connection.output.data;
+    while (a_connection.written != data.size())
+    {
+        auto const count = ::send(a_connection.fd, data.data() + a_connection.written,
+            data.size() - a_connection.written, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN and errno != EWOULDBLOCK)
+            {
+                close(a_connection);
+                return;
+            }
+            break;
+        }
+        a_connection.written += static_cast<std::size_t>(count);
+    }
+
+    bool const pending = (a_connection.written != data.size());
+    if (not pending)
+    {
+        data.clear();
+        a_connection.written = 0;
+        if (a_connection.closing)
+        {
+            close(a_connection);
+            return;
+        }
+    }
+
+    // Only ask to hear about writability while there is output waiting.
+    if (pending != a_connection.writing)
+    {
+        a_connection.writing = pending;
+        watch(a_connection);
+    }
+}
+
+void
+Server::
+watch(Connection & a_connection)
+{
+    // Watch for input until it ends, and for writability while output is waiting. Hang-ups and errors are always
+    // reported.
+    epoll_event event{};
+    event.events = (a_connection.input_done ? 0u : static_cast<std::uint32_t>(EPOLLIN))
+        | (a_connection.writing ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+    event.data.u64 = static_cast<std::uint64_t>(a_connection.fd);
+    ::epoll_ctl(m_epoll, EPOLL_CTL_MOD, a_connection.fd, &event);
+}
+
+void
+Server::
+finish_jobs()
+{
+    std::vector<Connection *> finished{};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        finished.swap(m_finished);
+    }
+    for (auto connection : finished)
+    {
+        connection->busy = false;
+        connection->closing = connection->closing or connection->game_over;
+        process(*connection);
+    }
+}
+
+void
+Server::
+close(Connection & a_connection)
+{
+    // The loop only closes a connection that no worker is using.
+    auto && game = a_connection.game;
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - a_connection.connected);
+    auto const duration = static_cast<std::uint64_t>(elapsed.count());
+    if (game.result() == Game::Result::Won)
+    {
+        m_stats.add_win(duration, game.clicks(), game.difficulty());
+    }
+    else if (game.result() == Game::Result::Lost)
+    {
+        m_stats.add_loss(duration, game.clicks());
+    }
+
+    auto const fd = a_connection.fd;
+    if (not a_connection.hung_up)
+    {
+        ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    ::close(fd);
+    m_connections.erase(fd);
+}
+
+void
+Server::
+run_worker()
+{
+    while (1)
+    {
+        Job job{};
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_jobs_ready.wait(lock, [this]() { return m_stop_workers or not m_jobs.empty(); });
+            if (m_stop_workers)
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        // The loop leaves a busy connection's game and output alone until the job is handed back.
+        auto && connection = *job.connection;
+        auto const command = Command::parse(job.line.data(), job.line.data() + job.line.size());
+        if (connection.game.execute(command, connection.os))
+        {
+            connection.os << prompt;
+        }
+        else
+        {
+            connection.game.write_outcome(connection.os);
+            connection.game_over = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_finished.push_back(job.connection);
+        }
+        wake();
+    }
+}
+
+void
+Server::
+wake()
+{
+    std::uint64_t const one = 1;
+    auto const written = ::write(m_wakeup, &one, sizeof(one));
+    static_cast<void>(written);
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Command.hpp"
+#include "Game.hpp"
+#include "Settings.hpp"
+#include "Stats.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace wade {
+
+// Host one game per connection on a local Unix socket, all driven by a single epoll event loop.
+//
+// Clients send the same line commands as the interactive game and get the same output back. Sockets are
+// non-blocking with input and output buffered per connection, so a slow client never stalls the others.
+// Commands that can take a long time on big boards run on a small pool of worker threads; the connection waits
+// for the result, queuing further input, while the loop carries on serving everyone else.
+class Server
+{
+public:
+    // Ctors. Boards with at least a_heavy_cells cells have their selects and autoplays run on the workers.
+    Server(Settings const &, std::size_t a_workers = 2, std::size_t a_heavy_cells = 1 << 16);
+    ~Server();
+
+    Server(Server const &) = delete;
+    Server & operator=(Server const &) = delete;
+
+    // Listen on a socket at the given path, replacing any socket file there.
+    // Return false and leave errno set on failure.
+    bool listen(std::string const & a_path);
+
+    // Serve connections until stop is called.
+    void run();
+
+    // Make run return. Safe to call from any thread or a signal handler.
+    void stop();
+
+    // Get number of open connections.
+    std::size_t connection_count() const { return m_connections.size(); }
+
+    // Get stats of the games finished on closed connections, timed from connecting to the end of the game.
+    Stats const & stats() const { return m_stats; }
+
+private:
+
+    // Stream buffer that appends to a string.
+    class Output : public std::streambuf
+    {
+    public:
+        std::string data = {};
+
+    protected:
+        int_type overflow(int_type a_ch) override { data += static_cast<char>(a_ch); return a_ch; }
+        std::streamsize xsputn(char const * a_chars, std::streamsize a_count) override
+        {
+            data.append(a_chars, static_cast<std::size_t>(a_count));
+            return a_count;
+        }
+    };
+
+    struct Connection
+    {
+        Connection(int a_fd, Settings const & a_settings) : fd{a_fd}, game{a_settings} {}
+
+        int fd;
+        Game game;
+        std::chrono::steady_clock::time_point connected = std::chrono::steady_clock::now();
+        std::string input = {};
+        Output output = {};
+        std::ostream os{&output};
+        std::size_t written = 0; // Output bytes already sent.
+        bool busy = false; // A worker is running a command; only the worker touches the game and output.
+        bool game_over = false; // Set by the worker when its command ended the game.
+        bool closing = false; // Close once the output is sent.
+        bool input_done = false; // Client has shut down its sending side; run the lines it sent, then close.
+        bool hung_up = false; // Client has gone or was dropped, so close without sending the output.
+        bool writing = false; // Waiting for the socket to become writable.
+    };
+
+    // Command line waiting for, or being run by, a worker.
+    struct Job
+    {
+        Connection * connection = nullptr;
+        std::string line = {};
+    };
+
+    void accept_connections();
+    void read(Connection &);
+    void process(Connection &);
+    void end_input(Connection &);
+    void hang_up(Connection &);
+    bool run_line(Connection &, char const * a_begin, char const * a_end);
+    bool is_heavy(Connection const &, Command const &) const;
+    void flush(Connection &);
+    void watch(Connection &);
+    void finish_jobs();
+    void close(Connection &);
+
+    void run_worker();
+    void wake();
+
+    Settings m_settings;
+    std::size_t m_heavy_cells;
+    std::uint64_t m_connection_number = 0;
+
+    int m_epoll = -1;
+    int m_listener = -1;
+    int m_wakeup = -1; // Event counter written by workers and stop to wake the loop.
+    std::string m_path = {};
+    std::unordered_map<int, std::unique_ptr<Connection>> m_connections = {};
+    Stats m_stats = {}; // Kept by the loop alone.
+
+    std::mutex m_mutex = {};
+    std::condition_variable m_jobs_ready = {};
+    std::deque<Job> m_jobs = {};
+    std::vector<Connection *> m_finished = {}; // Connections whose jobs are done, for the loop to pick up.
+    bool m_stop_workers = false;
+    std::vector<std::thread> m_workers = {};
+    std::atomic<bool> m_stop{false};
+};
+
+}
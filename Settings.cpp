@@ -11,6 +11,9 @@ operator<<(std::ostream & a_os, Settings const & a_settings)
         << "rows=" << a_settings.rows
         << ", cols=" << a_settings.cols
         << ", mines=" << a_settings.mines
+        << ", seed=" << a_settings.seed
+        << ", no_guess=" << a_settings.no_guess
+        << ", parallel_fill=" << a_settings.parallel_fill
         << "}"
         ;
     return a_os;
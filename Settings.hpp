@@ -10,6 +10,9 @@ struct Settings
     size_t rows = 1;
     size_t cols = 1;
     size_t mines = 1;
+    std::uint64_t seed = 0; // Seed for mine placement; 0 picks a new random seed for each game.
+    bool no_guess = false; // Place mines on the first select so the board can be solved without guessing.
+    size_t parallel_fill = size_t{1} << 18; // Reveal regions past this many cells on every core; 0 never does.
 };
 
 std::ostream & operator<<(std::ostream &, Settings const &);
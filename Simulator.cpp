@@ -0,0 +1,254 @@
+#include "Simulator.hpp"
+
+#include "FixedBoard.hpp"
+#include "FixedGame.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wade {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Get nanoseconds since the last lap and start the next. A worker's games are timed end to end, so each costs
+// a single clock read, plus one to skip the analysis of a win.
+std::uint64_t
+lap(Clock::time_point & a_last)
+{
+    auto const now = Clock::now();
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - a_last);
+    a_last = now;
+    return static_cast<std::uint64_t>(elapsed.count());
+}
+
+// State kept by each worker across the games it plays, on its own cache lines.
+struct alignas(64) Worker
+{
+    std::unique_ptr<Game> game = nullptr;
+    std::unique_ptr<Strategy> strategy = nullptr;
+    BoardAnalyzer analyzer = {};
+    Stats stats = {};
+    Clock::time_point last = {}; // End of the last game.
+};
+
+}
+
+Simulator::
+Simulator(Settings const & a_settings, StrategyFactory a_strategy_factory)
+    : m_settings{a_settings}
+    , m_strategy_factory{std::move(a_strategy_factory)}
+    , m_seed{(a_settings.seed != 0) ? a_settings.seed : Random::make_seed()}
+{
+    assert(m_strategy_factory);
+}
+
+Stats
+Simulator::
+run(std::size_t a_games, ThreadPool & a_pool)
+{
+    // Strategies that look only at the play board can play games of a standard size on a board of fixed size.
+    if (m_strategy_factory()->plays_blind() and not m_settings.no_guess)
+    {
+        Stats stats{};
+        auto run_preset =
+            [this, a_games, &a_pool, &stats](auto const * a_board)
+            {
+                stats = run_fixed<std::remove_cv_t<std::remove_pointer_t<decltype(a_board)>>>(a_games, a_pool);
+            };
+        if (with_preset_board(m_settings.rows, m_settings.cols, run_preset))
+        {
+            return stats;
+        }
+    }
+
+    std::vector<Worker> workers(a_pool.size());
+    a_pool.parallel_for(a_games,
+        [this, &workers](std::size_t a_game, std::size_t a_worker)
+        {
+            // Each worker reuses one game's buffers and one strategy for all of its games.
+            auto & worker = workers[a_worker];
+            if (not worker.game)
+            {
+                worker.game.reset(new Game{m_settings});
+                worker.strategy = m_strategy_factory();
+                worker.last = Clock::now();
+            }
+            worker.game->restart(game_seed(a_game));
+
+            std::size_t clicks = 0;
+            auto const result = play(*worker.game, *worker.strategy, clicks);
+            auto const duration = lap(worker.last);
+            if (result == Game::Result::Won)
+            {
+                worker.stats.add_win(duration, clicks, worker.analyzer.analyze(worker.game->real_board()).three_bv());
+
+                // Analysis is not play, so start timing the next game after it.
+                worker.last = Clock::now();
+            }
+            else if (result == Game::Result::Lost)
+            {
+                worker.stats.add_loss(duration, clicks);
+            }
+        });
+
+    // Workers are done, so their stats can be combined without locks; sketches merge exactly, in any order.
+    Stats stats{};
+    for (auto && worker : workers)
+    {
+        stats += worker.stats;
+    }
+    return stats;
+}
+
+BoardStats
+Simulator::
+analyze(std::size_t a_games, ThreadPool & a_pool)
+{
+    assert(not m_settings.no_guess);
+
+    // Boards of a standard size are placed on fixed-size boards, as run places them for random play.
+    BoardStats stats{};
+    auto analyze_preset =
+        [this, a_games, &a_pool, &stats](auto const * a_board)
+        {
+            using Board = std::remove_cv_t<std::remove_pointer_t<decltype(a_board)>>;
+            stats = analyze_games<FixedGame<Board>>(a_games, a_pool, [this]() { return m_settings.mines; });
+        };
+    if (not with_preset_board(m_settings.rows, m_settings.cols, analyze_preset))
+    {
+        stats = analyze_games<Game>(a_games, a_pool, [this]() { return m_settings; });
+    }
+    return stats;
+}
+
+template<typename GameType, typename Args>
+BoardStats
+Simulator::
+analyze_games(std::size_t a_games, ThreadPool & a_pool, Args a_args)
+{
+    struct alignas(64) BoardWorker
+    {
+        std::unique_ptr<GameType> game = nullptr;
+        BoardAnalyzer analyzer = {};
+        BoardStats stats = {};
+    };
+
+    // Each worker places the mines of its games on one board in turn, as run does, and analyzes it.
+    std::vector<BoardWorker> workers(a_pool.size());
+    a_pool.parallel_for(a_games,
+        [this, &workers, &a_args](std::size_t a_game, std::size_t a_worker)
+        {
+            auto & worker = workers[a_worker];
+            if (not worker.game)
+            {
+                worker.game.reset(new GameType{a_args()});
+            }
+            worker.game->restart(game_seed(a_game));
+            worker.stats.add(worker.analyzer.analyze(worker.game->real_board()));
+        });
+
+    BoardStats stats{};
+    for (auto && worker : workers)
+    {
+        stats += worker.stats;
+    }
+    return stats;
+}
+
+template<typename Board>
+Stats
+Simulator::
+run_fixed(std::size_t a_games, ThreadPool & a_pool)
+{
+    struct alignas(64) FixedWorker
+    {
+        std::unique_ptr<FixedGame<Board>> game = nullptr;
+        std::unique_ptr<Strategy> strategy = nullptr;
+        BoardAnalyzer analyzer = {};
+        Stats stats = {};
+        Clock::time_point last = {};
+    };
+
+    std::vector<FixedWorker> workers(a_pool.size());
+    a_pool.parallel_for(a_games,
+        [this, &workers](std::size_t a_game, std::size_t a_worker)
+        {
+            // Mirrors run and play, without going through Game.
+            auto & worker = workers[a_worker];
+            if (not worker.game)
+            {
+                worker.game.reset(new FixedGame<Board>{m_settings.mines});
+                worker.strategy = m_strategy_factory();
+                worker.last = Clock::now();
+            }
+            auto & game = *worker.game;
+            game.restart(game_seed(a_game));
+            worker.strategy->start(game.seed());
+            auto && board = game.play_board();
+            std::size_t clicks = 0;
+            while (game.result() == Game::Result::None)
+            {
+                game.select(worker.strategy->choose_hidden(&board[board.index(0, 0)], board.rows(), board.cols(),
+                    board.stride()));
+                ++clicks;
+            }
+
+            auto const duration = lap(worker.last);
+            if (game.result() == Game::Result::Won)
+            {
+                worker.stats.add_win(duration, clicks, worker.analyzer.analyze(game.real_board()).three_bv());
+
+                // Analysis is not play, so start timing the next game after it.
+                worker.last = Clock::now();
+            }
+            else
+            {
+                worker.stats.add_loss(duration, clicks);
+            }
+        });
+
+    Stats stats{};
+    for (auto && worker : workers)
+    {
+        stats += worker.stats;
+    }
+    return stats;
+}
+
+Random::Seed
+Simulator::
+game_seed(std::size_t a_game) const
+{
+    Random::Seed seed = 0;
+    for (std::uint64_t state = m_seed + a_game; seed == 0; )
+    {
+        seed = Random::mix(state);
+    }
+    return seed;
+}
+
+Game::Result
+Simulator::
+play(Game & a_game, Strategy & a_strategy, std::size_t & a_clicks)
+{
+    a_strategy.start(a_game);
+    while (a_game.result() == Game::Result::None)
+    {
+        // Give up on a strategy that stops making progress.
+        auto const revealed = a_game.revealed_count();
+        a_game.select(a_strategy.choose(a_game));
+        ++a_clicks;
+        if (a_game.result() == Game::Result::None and a_game.revealed_count() == revealed)
+        {
+            break;
+        }
+    }
+    return a_game.result();
+}
+
+}
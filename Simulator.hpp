@@ -0,0 +1,56 @@
+#pragma once
+
+#include "BoardAnalysis.hpp"
+#include "Game.hpp"
+#include "Random.hpp"
+#include "Settings.hpp"
+#include "Stats.hpp"
+#include "Strategy.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace wade {
+
+// Play many games without a player, spread across the workers of a thread pool.
+class Simulator
+{
+public:
+    using StrategyFactory = std::function<std::unique_ptr<Strategy>()>;
+
+    // Ctors. Each worker makes its own strategy with the factory.
+    Simulator(Settings const &, StrategyFactory);
+
+    // Play games and return the combined stats, with the time each game took on its worker.
+    Stats run(std::size_t a_games, ThreadPool &);
+
+    // Analyze the boards of the games run would play, without playing them. The settings must not be no_guess,
+    // whose boards depend on the first select.
+    BoardStats analyze(std::size_t a_games, ThreadPool &);
+
+    // Get seed for the given game. Seeds come from the settings' seed (or a random one if it is 0),
+    // so results do not depend on the number of threads.
+    Random::Seed game_seed(std::size_t a_game) const;
+    Random::Seed seed() const { return m_seed; }
+
+    // Play one game to the end with the strategy, counting the cells it selects.
+    static Game::Result play(Game &, Strategy &, std::size_t & a_clicks);
+
+private:
+
+    // Play games of a standard size at random on fixed-size boards, with the same results as run otherwise gets.
+    template<typename Board>
+    Stats run_fixed(std::size_t a_games, ThreadPool &);
+
+    // Analyze the real boards of games made from the arguments a_args returns.
+    template<typename GameType, typename Args>
+    BoardStats analyze_games(std::size_t a_games, ThreadPool &, Args a_args);
+
+    Settings m_settings;
+    StrategyFactory m_strategy_factory;
+    Random::Seed m_seed = 0;
+};
+
+}
@@ -0,0 +1,107 @@
+#include "Sketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace wade {
+
+constexpr std::size_t Sketch::sub_bits;
+constexpr std::size_t Sketch::sub_buckets;
+constexpr std::size_t Sketch::bucket_count;
+
+std::size_t
+Sketch::
+bucket(std::uint64_t a_value)
+{
+    // Values below sub_buckets each have a bucket; above, the top sub_bits + 1 bits pick the bucket within the
+    // value's power of two.
+    if (a_value < sub_buckets)
+    {
+        return static_cast<std::size_t>(a_value);
+    }
+    auto const magnitude = static_cast<std::size_t>(63 - __builtin_clzll(a_value)) - sub_bits;
+    return (magnitude + 1) * sub_buckets + static_cast<std::size_t>(a_value >> magnitude) - sub_buckets;
+}
+
+std::uint64_t
+Sketch::
+highest(std::size_t a_bucket)
+{
+    if (a_bucket < sub_buckets)
+    {
+        return a_bucket;
+    }
+    auto const magnitude = a_bucket / sub_buckets - 1;
+    auto const lowest = static_cast<std::uint64_t>(sub_buckets + a_bucket % sub_buckets) << magnitude;
+    return lowest + ((std::uint64_t{1} << magnitude) - 1);
+}
+
+void
+Sketch::
+add(std::uint64_t a_value)
+{
+    ++m_buckets[bucket(a_value)];
+    ++m_count;
+    m_sum += a_value;
+    m_min = std::min(m_min, a_value);
+    m_max = std::max(m_max, a_value);
+}
+
+Sketch &
+Sketch::
+operator+=(Sketch const & a_rhs)
+{
+    for (std::size_t b = 0; b != bucket_count; ++b)
+    {
+        m_buckets[b] += a_rhs.m_buckets[b];
+    }
+    m_count += a_rhs.m_count;
+    m_sum += a_rhs.m_sum;
+    m_min = std::min(m_min, a_rhs.m_min);
+    m_max = std::max(m_max, a_rhs.m_max);
+    return *this;
+}
+
+double
+Sketch::
+mean() const
+{
+    return (m_count != 0) ? static_cast<double>(m_sum) / m_count : 0;
+}
+
+std::uint64_t
+Sketch::
+quantile(double a_fraction) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    auto const rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(a_fraction * m_count)));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b != bucket_count; ++b)
+    {
+        seen += m_buckets[b];
+        if (seen >= rank)
+        {
+            return std::max(min(), std::min(highest(b), m_max));
+        }
+    }
+    return m_max;
+}
+
+std::ostream &
+operator<<(std::ostream & a_os, Sketch const & a_sketch)
+{
+    a_os << "count = " << a_sketch.count()
+        << ", mean = " << a_sketch.mean()
+        << ", p50 = " << a_sketch.quantile(0.5)
+        << ", p90 = " << a_sketch.quantile(0.9)
+        << ", p99 = " << a_sketch.quantile(0.99)
+        << ", max = " << a_sketch.max()
+        ;
+    return a_os;
+}
+
+}
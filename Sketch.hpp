@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+namespace wade {
+
+// Distribution of 64-bit values in constant memory, for quantiles over any number of values. Each power of two is
+// split into sub_buckets linear buckets, as in HdrHistogram, so a quantile is within 1/sub_buckets of the true
+// value. Two sketches merge by adding their buckets, exactly, so shards kept by separate threads combine into the
+// same sketch as one kept by a single thread.
+class Sketch
+{
+public:
+    static constexpr std::size_t sub_bits = 4;
+    static constexpr std::size_t sub_buckets = std::size_t{1} << sub_bits;
+    static constexpr std::size_t bucket_count = (64 - sub_bits + 1) * sub_buckets;
+
+    // Get bucket a value goes in, and the largest value that goes in a bucket.
+    static std::size_t bucket(std::uint64_t);
+    static std::uint64_t highest(std::size_t a_bucket);
+
+    void add(std::uint64_t);
+    Sketch & operator+=(Sketch const &);
+
+    std::uint64_t count() const { return m_count; }
+    std::uint64_t min() const { return (m_count != 0) ? m_min : 0; }
+    std::uint64_t max() const { return m_max; }
+    double mean() const;
+
+    // Get a value that at least the given fraction of the values are no greater than, to within the bucket size.
+    std::uint64_t quantile(double a_fraction) const;
+
+private:
+
+    std::array<std::uint64_t, bucket_count> m_buckets = {};
+    std::uint64_t m_count = 0;
+    std::uint64_t m_sum = 0;
+    std::uint64_t m_min = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t m_max = 0;
+};
+
+// Write count, mean, 50th, 90th and 99th percentiles and max.
+std::ostream & operator<<(std::ostream &, Sketch const &);
+
+}
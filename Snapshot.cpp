@@ -0,0 +1,268 @@
+#include "Snapshot.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace wade {
+
+constexpr std::uint32_t Snapshot::version;
+
+namespace {
+
+char const magic[8] = {'M', 'I', 'N', 'E', 'S', 'N', 'A', 'P'};
+
+// Memory map of a whole file, unmapped on destruction.
+class Mapping
+{
+public:
+    Mapping(int a_fd, std::size_t a_size, int a_protection)
+        : m_size{a_size}
+    {
+        auto const data = ::mmap(nullptr, a_size, a_protection, MAP_SHARED, a_fd, 0);
+        m_data = (data != MAP_FAILED) ? static_cast<char *>(data) : nullptr;
+    }
+    ~Mapping()
+    {
+        if (m_data)
+        {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    char * data() const { return m_data; }
+
+private:
+    char * m_data = nullptr;
+    std::size_t m_size;
+};
+
+// Close a file descriptor, keeping errno from what went wrong before.
+void
+close_keeping_errno(int a_fd)
+{
+    auto const error = errno;
+    ::close(a_fd);
+    errno = error;
+}
+
+}
+
+bool
+Snapshot::
+save(Game const & a_game, std::string const & a_path)
+{
+    static_assert(std::is_standard_layout<Header>::value, "snapshot header is copied as bytes");
+
+    auto && mines = a_game.m_mines;
+    auto && cells = a_game.m_play_board;
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.header_size = sizeof(Header);
+    header.rows = a_game.m_settings.rows;
+    header.cols = a_game.m_settings.cols;
+    header.mines = a_game.m_settings.mines;
+    header.settings_seed = a_game.m_settings.seed;
+    header.seed = a_game.m_seed;
+    header.hidden_count = a_game.m_hidden_count;
+    header.flagged_count = a_game.m_flagged_count;
+    header.revealed_count = a_game.m_revealed_count;
+    header.no_guess = a_game.m_settings.no_guess;
+    header.mines_pending = a_game.m_mines_pending;
+    header.result = static_cast<std::uint8_t>(a_game.m_result);
+    header.mines_offset = page_align(sizeof(Header));
+    header.mines_size = mines.data_size() * sizeof(MineField::Word);
+    header.cells_offset = page_align(header.mines_offset + header.mines_size);
+    header.cells_size = cells.size() * sizeof(Cell);
+    auto const size = header.cells_offset + header.cells_size;
+
+    // Write to a temporary file and rename it over the snapshot, so a failed save leaves the old one intact.
+    auto const temporary = a_path + ".tmp";
+    auto const fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = (::ftruncate(fd, static_cast<off_t>(size)) == 0);
+    if (ok)
+    {
+        Mapping mapping{fd, size, PROT_READ | PROT_WRITE};
+        ok = (mapping.data() != nullptr);
+        if (ok)
+        {
+            std::memcpy(mapping.data(), &header, sizeof(header));
+            std::memcpy(mapping.data() + header.mines_offset, mines.data(), header.mines_size);
+            std::memcpy(mapping.data() + header.cells_offset, cells.data(), header.cells_size);
+        }
+    }
+    ok = ok and (::fsync(fd) == 0);
+    close_keeping_errno(fd);
+    if (not ok or ::rename(temporary.c_str(), a_path.c_str()) != 0)
+    {
+        auto const error = errno;
+        ::unlink(temporary.c_str());
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Game>
+Snapshot::
+load(std::string const & a_path)
+{
+    auto const fd = ::open(a_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) != 0)
+    {
+        close_keeping_errno(fd);
+        return nullptr;
+    }
+    auto const file_size = static_cast<std::size_t>(status.st_size);
+    if (file_size < sizeof(Header))
+    {
+        ::close(fd);
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    Mapping mapping{fd, file_size, PROT_READ};
+    close_keeping_errno(fd);
+    if (not mapping.data())
+    {
+        return nullptr;
+    }
+
+    Header header{};
+    std::memcpy(&header, mapping.data(), sizeof(header));
+
+    // Work out the cell count and the section sizes the header's rows and columns call for, failing on overflow,
+    // and check every size and offset against the file before allocating anything for the game.
+    auto multiply =
+        [](std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t & a_product)
+        {
+            return not __builtin_mul_overflow(a, b, &a_product)
+                and not __builtin_mul_overflow(a_product, c, &a_product);
+        };
+    auto fits =
+        [file_size](std::uint64_t a_offset, std::uint64_t a_size)
+        {
+            std::uint64_t end = 0;
+            return a_offset >= sizeof(Header)
+                and not __builtin_add_overflow(a_offset, a_size, &end)
+                and end <= file_size;
+        };
+    std::uint64_t cells = 0;
+    std::uint64_t mines_size = 0;
+    std::uint64_t cells_size = 0;
+    auto const words = header.cols / MineField::word_bits + ((header.cols % MineField::word_bits) != 0);
+    auto is_zero = [](std::uint8_t a_byte) { return a_byte == 0; };
+    auto const valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0
+        and header.version == version
+        and header.header_size == sizeof(Header)
+        and header.rows != 0 and header.cols != 0
+        and header.rows <= file_size and header.cols <= file_size
+        and multiply(header.rows, header.cols, 1, cells)
+        and multiply(header.rows + 2, words + 2, sizeof(MineField::Word), mines_size)
+        and multiply(header.rows + 2, header.cols + 2, sizeof(Cell), cells_size)
+        and header.hidden_count <= cells and header.flagged_count <= cells and header.revealed_count <= cells
+        and header.hidden_count + header.flagged_count + header.revealed_count == cells
+        and (header.mines_pending == 0 or header.revealed_count == 0)
+        and header.result <= static_cast<std::uint8_t>(Game::Result::Quit)
+        and std::all_of(std::begin(header.padding), std::end(header.padding), is_zero)
+        and header.mines_size == mines_size and fits(header.mines_offset, header.mines_size)
+        and header.cells_size == cells_size and fits(header.cells_offset, header.cells_size);
+    if (not valid)
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    // Build the game with its mines pending, which places none, as they are about to be copied in.
+    Settings settings{header.rows, header.cols, header.mines, header.settings_seed, true};
+    std::unique_ptr<Game> game{new Game{settings}};
+    assert(header.mines_size == game->m_mines.data_size() * sizeof(MineField::Word));
+    assert(header.cells_size == game->m_play_board.size() * sizeof(Cell));
+
+    game->m_settings.no_guess = (header.no_guess != 0);
+    game->m_seed = header.seed;
+    std::memcpy(game->m_mines.data(), mapping.data() + header.mines_offset, header.mines_size);
+    game->m_mines.recount();
+    game->m_mines_pending = (header.mines_pending != 0);
+    if (not game->m_mines.padding_clear() or (game->m_mines_pending and game->m_mines.count() != 0))
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+    game->count_adjacent_mines();
+    std::memcpy(game->m_play_board.data(), mapping.data() + header.cells_offset, header.cells_size);
+
+    game->m_result = static_cast<Game::Result>(header.result);
+    game->m_hidden_count = header.hidden_count;
+    game->m_flagged_count = header.flagged_count;
+    game->m_revealed_count = header.revealed_count;
+
+    // Check the play board holds only cells a game can have, with its border intact and each revealed cell showing
+    // the real board's count, so none is a mine, and tell the solver about every revealed cell; it works out the
+    // rest when next asked.
+    FloodFill::Indices revealed{};
+    revealed.reserve(header.revealed_count);
+    auto && board = game->m_play_board;
+    auto const stride = board.stride();
+    auto is_border = [](Cell a_cell) { return a_cell == Cell::Border; };
+    bool board_valid = std::all_of(board.data(), board.data() + stride, is_border)
+        and std::all_of(board.data() + board.size() - stride, board.data() + board.size(), is_border);
+    std::size_t flagged = 0;
+    for (std::size_t i = 0; i != board.rows() and board_valid; ++i)
+    {
+        auto row = board.row_data(i);
+        board_valid = is_border(row[-1]) and is_border(row[board.cols()]);
+        for (std::size_t j = 0; j != board.cols(); ++j)
+        {
+            if (row[j] >= Cell::Zero and row[j] <= Cell::Eight)
+            {
+                revealed.push_back(board.index(i, j));
+                board_valid = board_valid and row[j] == game->m_real_board[revealed.back()];
+            }
+            else if (row[j] == Cell::Flagged)
+            {
+                ++flagged;
+            }
+            else if (row[j] != Cell::Hidden)
+            {
+                board_valid = false;
+            }
+        }
+    }
+    if (not board_valid or revealed.size() != header.revealed_count or flagged != header.flagged_count)
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+    game->m_solver.reset(board);
+    game->m_solver.reveal(revealed);
+    game->m_flagged_known_mines = 0;
+    return game;
+}
+
+std::size_t
+Snapshot::
+page_align(std::size_t a_offset)
+{
+    static std::size_t const page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return (a_offset + page_size - 1) / page_size * page_size;
+}
+
+}
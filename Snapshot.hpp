@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Game.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace wade {
+
+// Save and restore games as binary snapshots, written and read through memory maps.
+//
+// A snapshot is a fixed header followed by two page-aligned sections holding the mine bit planes and the play
+// board's cells exactly as they are laid out in memory, so saving and restoring are bulk copies with no formatting
+// or parsing. The real board is rebuilt from the mines, and the solver from the revealed cells, on restore.
+class Snapshot
+{
+public:
+    static constexpr std::uint32_t version = 1;
+
+    // Save game to a file, replacing it only once the whole snapshot is written.
+    // Return false and leave errno set on failure.
+    static bool save(Game const &, std::string const & a_path);
+
+    // Restore a game from a file. Return null and leave errno set on failure; EINVAL means it is not a snapshot
+    // this version can read.
+    static std::unique_ptr<Game> load(std::string const & a_path);
+
+private:
+
+    // Fixed-size header at the start of the file, in the machine's own byte order.
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::uint64_t rows;
+        std::uint64_t cols;
+        std::uint64_t mines;
+        std::uint64_t settings_seed;
+        std::uint64_t seed;
+        std::uint64_t hidden_count;
+        std::uint64_t flagged_count;
+        std::uint64_t revealed_count;
+        std::uint8_t no_guess;
+        std::uint8_t mines_pending;
+        std::uint8_t result;
+        std::uint8_t padding[5];
+        std::uint64_t mines_offset;
+        std::uint64_t mines_size; // Bytes.
+        std::uint64_t cells_offset;
+        std::uint64_t cells_size; // Bytes.
+    };
+
+    static std::size_t page_align(std::size_t);
+};
+
+}
@@ -0,0 +1,285 @@
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace wade {
+
+namespace {
+
+// Determine if the player sees a number on the cell.
+bool
+is_number(Cell a_cell)
+{
+    return a_cell >= Cell::One and a_cell <= Cell::Eight;
+}
+
+// Determine if the player cannot see the cell.
+bool
+is_hidden(Cell a_cell)
+{
+    return a_cell == Cell::Hidden or a_cell == Cell::Flagged;
+}
+
+}
+
+bool
+Solver::Constraint::
+contains(std::size_t a_index) const
+{
+    return std::find(cells.begin(), cells.begin() + size, a_index) != cells.begin() + size;
+}
+
+Solver::
+Solver(Board const & a_play_board)
+{
+    reset(a_play_board);
+}
+
+void
+Solver::
+reset(Board const & a_play_board)
+{
+    auto const stride = static_cast<std::ptrdiff_t>(a_play_board.stride());
+    m_nearby.clear();
+    for (std::ptrdiff_t i = -2; i <= 2; ++i)
+    {
+        for (std::ptrdiff_t j = -2; j <= 2; ++j)
+        {
+            if (i != 0 or j != 0)
+            {
+                m_nearby.push_back(i * stride + j);
+            }
+        }
+    }
+
+    m_state.assign(a_play_board.size(), State::Unknown);
+    m_queued.assign(a_play_board.size(), false);
+    m_revealed.clear();
+    m_dirty.clear();
+    m_safe.clear();
+    m_mines.clear();
+}
+
+void
+Solver::
+reveal(Indices const & a_indices)
+{
+    // Only note the cells here; the work of finding the numbers to examine is left to solve.
+    m_revealed.insert(m_revealed.end(), a_indices.begin(), a_indices.end());
+}
+
+std::size_t
+Solver::
+solve(Board const & a_play_board)
+{
+    assert(a_play_board.size() == m_state.size());
+
+    // A revealed cell changes the constraint of each number around it, and is a new constraint itself.
+    for (auto && index : m_revealed)
+    {
+        m_state[index] = State::Safe;
+        queue(a_play_board, index);
+        queue_neighbors(a_play_board, index);
+    }
+    m_revealed.clear();
+
+    std::size_t found = 0;
+    while (not m_dirty.empty())
+    {
+        auto const index = m_dirty.back();
+        m_dirty.pop_back();
+        m_queued[index] = false;
+        found += examine(a_play_board, index);
+    }
+    return found;
+}
+
+bool
+Solver::
+next_safe(Board const & a_play_board, std::size_t & a_index)
+{
+    while (not m_safe.empty())
+    {
+        a_index = m_safe.back();
+        m_safe.pop_back();
+        if (is_hidden(a_play_board[a_index]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Solver::
+queue(Board const & a_play_board, std::size_t a_index)
+{
+    if (is_number(a_play_board[a_index]) and not m_queued[a_index])
+    {
+        m_queued[a_index] = true;
+        m_dirty.push_back(a_index);
+    }
+}
+
+void
+Solver::
+queue_neighbors(Board const & a_play_board, std::size_t a_index)
+{
+    // Every cell on the board has all 8 neighbors in the buffer thanks to the border.
+    for (auto && delta : a_play_board.neighbors())
+    {
+        queue(a_play_board, a_index + delta);
+    }
+}
+
+Solver::Constraint
+Solver::
+constraint(Board const & a_play_board, std::size_t a_index) const
+{
+    Constraint result{};
+    result.mines = static_cast<int>(a_play_board[a_index]);
+    for (auto && delta : a_play_board.neighbors())
+    {
+        auto const adj_index = a_index + delta;
+        if (not is_hidden(a_play_board[adj_index]))
+        {
+            continue;
+        }
+        if (m_state[adj_index] == State::Mine)
+        {
+            --result.mines;
+        }
+        else if (m_state[adj_index] == State::Unknown)
+        {
+            result.cells[result.size++] = adj_index;
+        }
+    }
+    return result;
+}
+
+std::size_t
+Solver::
+examine(Board const & a_play_board, std::size_t a_index)
+{
+    auto const a = constraint(a_play_board, a_index);
+    if (a.size == 0)
+    {
+        return 0;
+    }
+
+    // Single number: all of its mines are known, or all of its unknown cells must be mines.
+    if (a.mines == 0 or a.mines == static_cast<int>(a.size))
+    {
+        auto const state = (a.mines == 0) ? State::Safe : State::Mine;
+        std::size_t found = 0;
+        for (std::size_t i = 0; i != a.size; ++i)
+        {
+            found += mark(a_play_board, a.cells[i], state);
+        }
+        return found;
+    }
+
+    // Pairs of numbers: only numbers within 2 rows and columns can share unknown cells.
+    std::size_t found = 0;
+    for (auto && delta : m_nearby)
+    {
+        auto const other_index = a_index + delta;
+        if (other_index >= a_play_board.size() or not is_number(a_play_board[other_index]))
+        {
+            continue;
+        }
+        found += examine_pair(a_play_board, a, constraint(a_play_board, other_index));
+        if (found != 0)
+        {
+            // Examine this number again later with its updated constraint.
+            queue(a_play_board, a_index);
+            break;
+        }
+    }
+    return found;
+}
+
+std::size_t
+Solver::
+examine_pair(Board const & a_play_board, Constraint const & a, Constraint const & b)
+{
+    std::size_t shared = 0;
+    for (std::size_t i = 0; i != a.size; ++i)
+    {
+        shared += b.contains(a.cells[i]) ? 1 : 0;
+    }
+    if (shared == 0)
+    {
+        return 0;
+    }
+
+    // The shared cells hold between min_shared and max_shared mines; the rest of each number's mines are outside.
+    auto const only_a = static_cast<int>(a.size - shared);
+    auto const only_b = static_cast<int>(b.size - shared);
+    auto const min_shared = std::max({0, a.mines - only_a, b.mines - only_b});
+    auto const max_shared = std::min({static_cast<int>(shared), a.mines, b.mines});
+    if (min_shared > max_shared)
+    {
+        return 0;
+    }
+
+    std::size_t found = 0;
+    auto mark_only =
+        [this, &a_play_board, &found](Constraint const & x, Constraint const & y, State a_state)
+        {
+            for (std::size_t i = 0; i != x.size; ++i)
+            {
+                if (not y.contains(x.cells[i]))
+                {
+                    found += mark(a_play_board, x.cells[i], a_state);
+                }
+            }
+        };
+
+    // Each number has its remaining mines outside the shared cells; mark those cells if that count is forced
+    // to none or to all of them.
+    if (only_a != 0 and a.mines - min_shared == 0)
+    {
+        mark_only(a, b, State::Safe);
+    }
+    else if (only_a != 0 and a.mines - max_shared == only_a)
+    {
+        mark_only(a, b, State::Mine);
+    }
+    if (only_b != 0 and b.mines - min_shared == 0)
+    {
+        mark_only(b, a, State::Safe);
+    }
+    else if (only_b != 0 and b.mines - max_shared == only_b)
+    {
+        mark_only(b, a, State::Mine);
+    }
+    return found;
+}
+
+std::size_t
+Solver::
+mark(Board const & a_play_board, std::size_t a_index, State a_state)
+{
+    if (m_state[a_index] != State::Unknown)
+    {
+        return 0;
+    }
+    m_state[a_index] = a_state;
+    if (a_state == State::Safe)
+    {
+        m_safe.push_back(a_index);
+    }
+    else
+    {
+        m_mines.push_back(a_index);
+    }
+
+    // Each number around the cell has one less unknown cell.
+    queue_neighbors(a_play_board, a_index);
+    return 1;
+}
+
+}
+
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Board.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wade {
+
+// Deduces cells that are certainly safe or certainly mines from the numbers on the play board.
+//
+// Two rules are applied: a single number whose mines are all found (or whose hidden neighbors must all be mines),
+// and a pair of nearby numbers whose hidden neighbors overlap. The solver is incremental: it only examines numbers
+// next to cells that changed since the last solve, so solving a whole game costs time proportional to the cells
+// revealed rather than to the size of the board. Flags placed by the player are not trusted.
+class Solver
+{
+public:
+    using Indices = std::vector<std::size_t>;
+
+    // Ctors.
+    Solver() = default;
+    Solver(Board const &);
+
+    // Forget everything, e.g. for a new game on the given play board.
+    void reset(Board const &);
+
+    // Note cells that were just revealed, so the next solve examines the numbers around them.
+    void reveal(Indices const &);
+
+    // Make deductions from the cells noted since the last solve. Return number of new safe cells and mines found.
+    std::size_t solve(Board const & a_play_board);
+
+    // Take a safe cell that is still hidden on the play board. Return false if there is none.
+    bool next_safe(Board const & a_play_board, std::size_t & a_index);
+
+    // Determine if a cell is known to be a mine, and get all known mines in the order they were found.
+    bool is_mine(std::size_t a_index) const { return m_state[a_index] == State::Mine; }
+    Indices const & mines() const { return m_mines; }
+
+private:
+
+    enum class State : std::uint8_t
+    {
+        Unknown,
+        Safe,
+        Mine,
+    };
+
+    // Hidden neighbors of a number that are not known yet, and how many of them are mines.
+    struct Constraint
+    {
+        std::array<std::size_t, 8> cells = {};
+        std::size_t size = 0;
+        int mines = 0;
+
+        bool contains(std::size_t a_index) const;
+    };
+
+    void queue(Board const &, std::size_t a_index);
+    void queue_neighbors(Board const &, std::size_t a_index);
+    Constraint constraint(Board const &, std::size_t a_index) const;
+    std::size_t examine(Board const &, std::size_t a_index);
+    std::size_t examine_pair(Board const &, Constraint const &, Constraint const &);
+    std::size_t mark(Board const &, std::size_t a_index, State);
+
+    std::vector<std::ptrdiff_t> m_nearby = {}; // Distances to the cells within 2 rows and columns.
+
+    std::vector<State> m_state = {};
+    std::vector<bool> m_queued = {};
+    Indices m_revealed = {}; // Cells revealed since the last solve.
+    Indices m_dirty = {}; // Numbers to examine.
+    Indices m_safe = {}; // Safe cells not yet handed out.
+    Indices m_mines = {};
+};
+
+}
+
@@ -4,6 +4,25 @@
 
 namespace wade {
 
+void
+Stats::
+add_win(std::uint64_t a_duration, std::uint64_t a_clicks, std::uint64_t a_difficulty)
+{
+    ++wins;
+    duration.add(a_duration);
+    clicks.add(a_clicks);
+    difficulty.add(a_difficulty);
+}
+
+void
+Stats::
+add_loss(std::uint64_t a_duration, std::uint64_t a_clicks)
+{
+    ++losses;
+    duration.add(a_duration);
+    clicks.add(a_clicks);
+}
+
 double
 Stats::
 percentage() const
@@ -13,7 +32,19 @@ percentage() const
     {
         return 0;
     }
-    return 100. * (wins / total);
+    return 100. * wins / total;
+}
+
+Stats &
+Stats::
+operator+=(Stats const & a_rhs)
+{
+    wins += a_rhs.wins;
+    losses += a_rhs.losses;
+    duration += a_rhs.duration;
+    clicks += a_rhs.clicks;
+    difficulty += a_rhs.difficulty;
+    return *this;
 }
 
 std::ostream &
@@ -23,8 +54,18 @@ operator<<(std::ostream & a_os, Stats const & a_stats)
         << ", losses = " << a_stats.losses
         << ", win_percentage = " << a_stats.percentage()
         ;
+    auto write_sketch =
+        [&a_os](char const * a_name, Sketch const & a_sketch)
+        {
+            if (a_sketch.count() != 0)
+            {
+                a_os << '\n' << a_name << ": " << a_sketch;
+            }
+        };
+    write_sketch("duration_ns", a_stats.duration);
+    write_sketch("clicks", a_stats.clicks);
+    write_sketch("difficulty_3bv", a_stats.difficulty);
     return a_os;
 }
 
 }
-
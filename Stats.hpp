@@ -1,20 +1,34 @@
 #pragma once
 
+#include "Sketch.hpp"
+
 #include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 
 namespace wade {
 
+// Results of a population of games, in constant memory however many games are counted.
 struct Stats
 {
     std::size_t wins = 0;
     std::size_t losses = 0;
+    Sketch duration = {}; // Time each game took, in nanoseconds.
+    Sketch clicks = {}; // Selects, flags, chords and autoplays in each game.
+    Sketch difficulty = {}; // 3BV of each board won.
+
+    // Count a game won or lost, with its time and clicks, and for a win the 3BV of its board.
+    void add_win(std::uint64_t a_duration, std::uint64_t a_clicks, std::uint64_t a_difficulty);
+    void add_loss(std::uint64_t a_duration, std::uint64_t a_clicks);
 
     // Calculate win percentage.
     double percentage() const;
+
+    // Add counts from another set of stats, e.g. to combine stats gathered on separate threads.
+    Stats & operator+=(Stats const &);
 };
 
+// Write wins and losses on one line, then a line for each sketch that has values.
 std::ostream & operator<<(std::ostream &, Stats const &);
 
 }
-
@@ -0,0 +1,97 @@
+#include "Strategy.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+namespace wade {
+
+Coord
+Strategy::
+choose_hidden(Cell const *, std::size_t, std::size_t, std::size_t)
+{
+    assert(not "strategy plays blind");
+    return Coord{};
+}
+
+void
+RandomStrategy::
+start(Game const & a_game)
+{
+    start(a_game.seed());
+}
+
+void
+RandomStrategy::
+start(Random::Seed a_seed)
+{
+    // Follow the game's seed so a game is played the same way on any thread.
+    std::uint64_t state = a_seed;
+    m_random = Random{Random::mix(state)};
+}
+
+Coord
+RandomStrategy::
+choose(Game & a_game)
+{
+    assert(a_game.hidden_count() != 0);
+    auto && board = a_game.play_board();
+    return choose_hidden(&board[board.index(0, 0)], board.rows(), board.cols(), board.stride());
+}
+
+Coord
+RandomStrategy::
+choose_hidden(Cell const * a_cells, std::size_t a_rows, std::size_t a_cols, std::size_t a_stride)
+{
+    // Try random cells until finding a hidden one; hidden cells are rarely scarce on a board that is still in play.
+    while (1)
+    {
+        auto const row = m_random.uniform(a_rows);
+        auto const col = m_random.uniform(a_cols);
+        if (a_cells[row * a_stride + col] == Cell::Hidden)
+        {
+            return Coord{static_cast<std::int64_t>(row), static_cast<std::int64_t>(col)};
+        }
+    }
+}
+
+Coord
+SolverStrategy::
+choose(Game & a_game)
+{
+    Coord coord{};
+    if (a_game.find_safe(coord))
+    {
+        return coord;
+    }
+
+    // Guess; a hidden cell that is not a known mine exists while the game is in play.
+    do
+    {
+        coord = RandomStrategy::choose(a_game);
+    }
+    while (a_game.is_known_mine(coord));
+    return coord;
+}
+
+ProbabilityStrategy::
+ProbabilityStrategy(ThreadPool * a_pool)
+    : m_probability_solver{a_pool}
+{
+}
+
+Coord
+ProbabilityStrategy::
+choose(Game & a_game)
+{
+    Coord coord{};
+    if (a_game.find_safe(coord))
+    {
+        return coord;
+    }
+
+    auto && board = a_game.play_board();
+    m_probability_solver.solve(board, a_game.mine_count(), a_game.solver());
+    return board.coord(m_probability_solver.safest(board));
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Cell.hpp"
+#include "Coord.hpp"
+#include "Game.hpp"
+#include "ProbabilitySolver.hpp"
+#include "Random.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wade {
+
+// Chooses moves for a game played without a player.
+class Strategy
+{
+public:
+    virtual ~Strategy() = default;
+
+    // Prepare to play a new game.
+    virtual void start(Game const &) {}
+
+    // Choose a hidden cell to select next. Strategies may use the game's solver, which is why the game is not const.
+    virtual Coord choose(Game &) = 0;
+
+    // Determine if the strategy looks at nothing but the game's seed and play board, so it can also play games on
+    // other kinds of board, such as the simulator's boards of fixed size, through the functions below.
+    virtual bool plays_blind() const { return false; }
+
+    // Prepare to play a new game with the given seed, for a strategy that plays blind.
+    virtual void start(Random::Seed) {}
+
+    // Choose a hidden cell of a play board laid out as Board is, given its first cell, for a strategy that plays
+    // blind.
+    virtual Coord choose_hidden(Cell const * a_cells, std::size_t a_rows, std::size_t a_cols, std::size_t a_stride);
+};
+
+// Select hidden cells uniformly at random.
+class RandomStrategy : public Strategy
+{
+public:
+    void start(Game const &) override;
+    Coord choose(Game &) override;
+
+    bool plays_blind() const override { return true; }
+    void start(Random::Seed) override;
+    Coord choose_hidden(Cell const * a_cells, std::size_t a_rows, std::size_t a_cols, std::size_t a_stride) override;
+
+private:
+
+    Random m_random{1};
+};
+
+// Select cells the solver proves safe, and guess at random among cells not known to be mines otherwise.
+class SolverStrategy : public RandomStrategy
+{
+public:
+    Coord choose(Game &) override;
+
+    // Needs the game's solver.
+    bool plays_blind() const override { return false; }
+};
+
+// Select cells the solver proves safe, and otherwise the cell least likely to be a mine.
+class ProbabilityStrategy : public Strategy
+{
+public:
+    // Ctors. With a thread pool, a board's frontier components are solved in parallel.
+    ProbabilityStrategy(ThreadPool * = nullptr);
+
+    Coord choose(Game &) override;
+
+private:
+
+    ProbabilitySolver m_probability_solver;
+};
+
+}
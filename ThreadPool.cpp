@@ -0,0 +1,258 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace wade {
+
+constexpr std::size_t ThreadPool::parallel_cells;
+
+namespace {
+
+// Pool and worker number of the current thread while it runs a parallel loop.
+thread_local ThreadPool const * current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+
+// Make the current thread a worker of a pool until the end of the scope.
+class WorkerScope
+{
+public:
+    WorkerScope(ThreadPool const * a_pool, std::size_t a_worker)
+        : m_pool{current_pool}
+        , m_worker{current_worker}
+    {
+        current_pool = a_pool;
+        current_worker = a_worker;
+    }
+
+    ~WorkerScope()
+    {
+        current_pool = m_pool;
+        current_worker = m_worker;
+    }
+
+    WorkerScope(WorkerScope const &) = delete;
+    WorkerScope & operator=(WorkerScope const &) = delete;
+
+private:
+
+    ThreadPool const * m_pool;
+    std::size_t m_worker;
+};
+
+std::uint64_t
+pack(std::uint64_t a_begin, std::uint64_t a_end)
+{
+    return a_begin | (a_end << 32);
+}
+
+std::uint64_t begin_of(std::uint64_t a_range) { return a_range & 0xFFFFFFFF; }
+std::uint64_t end_of(std::uint64_t a_range) { return a_range >> 32; }
+
+}
+
+ThreadPool::
+ThreadPool(std::size_t a_workers)
+    : m_slices(a_workers != 0 ? a_workers : std::max(1u, std::thread::hardware_concurrency()))
+{
+    // Worker 0 is the thread that calls parallel_for.
+    for (std::size_t w = 1; w != size(); ++w)
+    {
+        m_threads.emplace_back([this, w]() { run_worker(w); });
+    }
+}
+
+ThreadPool::
+~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto && thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool &
+ThreadPool::
+shared()
+{
+    static ThreadPool pool{};
+    return pool;
+}
+
+void
+ThreadPool::
+parallel_for(std::size_t a_count, Task const & a_task)
+{
+    if (a_count == 0)
+    {
+        return;
+    }
+
+    // Run nested loops and loops on a single worker on the calling thread. A loop nested in one of ours keeps
+    // the worker it runs on, which is busy with this call; any other runs as worker 0, which the loop has to itself.
+    if (current_pool != nullptr or size() == 1)
+    {
+        WorkerScope scope{this, (current_pool == this) ? current_worker : 0};
+        for (std::size_t i = 0; i != a_count; ++i)
+        {
+            a_task(i, current_worker);
+        }
+        return;
+    }
+
+    assert(a_count <= std::numeric_limits<std::uint32_t>::max());
+    std::lock_guard<std::mutex> loop_lock{m_loop_mutex};
+
+    // Give each worker an equal slice to start with.
+    for (std::size_t w = 0; w != size(); ++w)
+    {
+        m_slices[w].range.store(pack(a_count * w / size(), a_count * (w + 1) / size()), std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_task = &a_task;
+        m_error = nullptr;
+        m_running = size();
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    {
+        WorkerScope scope{this, 0};
+        work(0);
+    }
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_done.wait(lock, [this]() { return m_running == 0; });
+    m_task = nullptr;
+    if (m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void
+ThreadPool::
+for_each_band(std::size_t a_rows, std::size_t a_cols, BandTask const & a_task)
+{
+    if (a_rows * a_cols < parallel_cells)
+    {
+        a_task(0, a_rows);
+        return;
+    }
+
+    // A few bands per worker lets faster workers take over the bands of slower ones.
+    auto & pool = shared();
+    auto const bands = std::min(a_rows, 4 * pool.size());
+    pool.parallel_for(bands,
+        [a_rows, bands, &a_task](std::size_t a_band, std::size_t)
+        {
+            a_task(a_rows * a_band / bands, a_rows * (a_band + 1) / bands);
+        });
+}
+
+void
+ThreadPool::
+run_worker(std::size_t a_worker)
+{
+    WorkerScope scope{this, a_worker};
+
+    std::uint64_t generation = 0;
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_start.wait(lock, [this, generation]() { return m_stop or m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+        work(a_worker);
+    }
+}
+
+void
+ThreadPool::
+work(std::size_t a_worker)
+{
+    std::size_t index = 0;
+    while (take(a_worker, index) or steal(a_worker, index))
+    {
+        try
+        {
+            (*m_task)(index, a_worker);
+        }
+        catch (...)
+        {
+            // Keep the first error to rethrow on the calling thread.
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (not m_error)
+            {
+                m_error = std::current_exception();
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    --m_running;
+    if (m_running == 0)
+    {
+        m_done.notify_one();
+    }
+}
+
+bool
+ThreadPool::
+take(std::size_t a_worker, std::size_t & a_index)
+{
+    // Take the first index of our own slice.
+    auto & range = m_slices[a_worker].range;
+    auto r = range.load(std::memory_order_acquire);
+    while (begin_of(r) < end_of(r))
+    {
+        if (range.compare_exchange_weak(r, pack(begin_of(r) + 1, end_of(r)), std::memory_order_acq_rel))
+        {
+            a_index = begin_of(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ThreadPool::
+steal(std::size_t a_thief, std::size_t & a_index)
+{
+    // Look for a victim with work left, starting with the next worker so thieves spread out.
+    for (std::size_t k = 1; k != size(); ++k)
+    {
+        auto & range = m_slices[(a_thief + k) % size()].range;
+        auto r = range.load(std::memory_order_acquire);
+        while (begin_of(r) < end_of(r))
+        {
+            // Take the back half of the victim's slice, leaving it the front half.
+            auto const begin = begin_of(r);
+            auto const end = end_of(r);
+            auto const mid = begin + (end - begin) / 2;
+            if (range.compare_exchange_weak(r, pack(begin, mid), std::memory_order_acq_rel))
+            {
+                // Run the first stolen index now and keep the rest as our own slice.
+                a_index = mid;
+                m_slices[a_thief].range.store(pack(mid + 1, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wade {
+
+// Fixed set of worker threads that run parallel loops.
+//
+// Each worker starts with an equal slice of the loop's indices and takes indices from the front of its own slice;
+// a worker whose slice is empty steals the back half of another worker's slice. Slices are single atomic words,
+// so taking and stealing work never lock.
+class ThreadPool
+{
+public:
+    using Task = std::function<void(std::size_t a_index, std::size_t a_worker)>;
+    using BandTask = std::function<void(std::size_t a_begin, std::size_t a_end)>;
+
+    // Boards with at least this many cells are worth splitting across the shared pool.
+    static constexpr std::size_t parallel_cells = std::size_t{1} << 20;
+
+    // Ctors. The calling thread counts as one of the workers; 0 means one worker per hardware thread.
+    ThreadPool(std::size_t a_workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+
+    // Get pool shared by the whole program, with one worker per hardware thread, created on first use.
+    static ThreadPool & shared();
+
+    // Get number of workers, including the calling thread.
+    std::size_t size() const { return m_slices.size(); }
+
+    // Call task for each index in [0, a_count) and wait for all calls to finish.
+    // Worker numbers passed to the task are in [0, size()), and no two calls with the same worker run at once.
+    // A parallel loop started from inside a task, of this pool or another, runs serially on the calling thread.
+    void parallel_for(std::size_t a_count, Task const &);
+
+    // Split the rows [0, a_rows) of a board a_cols wide into bands and call task with each band's rows [begin, end).
+    // Boards of parallel_cells or more run their bands on the shared pool; smaller ones run as one band here.
+    static void for_each_band(std::size_t a_rows, std::size_t a_cols, BandTask const &);
+
+private:
+
+    // Half-open range of indices [begin, end) packed into one word: begin in the low half, end in the high half.
+    struct alignas(64) Slice
+    {
+        std::atomic<std::uint64_t> range{0};
+    };
+
+    void run_worker(std::size_t a_worker);
+    void work(std::size_t a_worker);
+    bool take(std::size_t a_worker, std::size_t & a_index);
+    bool steal(std::size_t a_thief, std::size_t & a_index);
+
+    std::vector<Slice> m_slices;
+    std::vector<std::thread> m_threads = {};
+
+    std::mutex m_loop_mutex = {}; // Allows one parallel loop at a time.
+    std::mutex m_mutex = {};
+    std::condition_variable m_start = {};
+    std::condition_variable m_done = {};
+    std::uint64_t m_generation = 0; // Incremented for each loop so workers know to start.
+    std::size_t m_running = 0; // Workers still running the current loop.
+    bool m_stop = false;
+
+    Task const * m_task = nullptr;
+    std::exception_ptr m_error = nullptr;
+};
+
+}
+
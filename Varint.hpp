@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wade {
+
+// Variable-length unsigned integers, 7 bits per byte with the high bit set on all but the last byte.
+
+// Largest number of bytes a 64-bit number takes.
+constexpr std::size_t max_varint_size = 10;
+
+// Write number at a_out, which must have room for max_varint_size bytes. Return end of what was written.
+inline
+char *
+write_varint(std::uint64_t a_number, char * a_out)
+{
+    while (a_number >= 0x80)
+    {
+        *a_out++ = static_cast<char>((a_number & 0x7F) | 0x80);
+        a_number >>= 7;
+    }
+    *a_out++ = static_cast<char>(a_number);
+    return a_out;
+}
+
+// Read number from [a_pos, a_end), advancing a_pos past it. Return false if it is cut off or too long.
+inline
+bool
+read_varint(char const * & a_pos, char const * a_end, std::uint64_t & a_number)
+{
+    std::uint64_t number = 0;
+    for (unsigned shift = 0; a_pos != a_end and shift < 64; shift += 7)
+    {
+        auto const byte = static_cast<std::uint8_t>(*a_pos++);
+        number |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            a_number = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,357 @@
+#include "Board.hpp"
+#include "FloodFill.hpp"
+#include "Game.hpp"
+#include "Metrics.hpp"
+#include "Settings.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Count heap allocations made by the benchmarked code.
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}
+
+void *
+operator new(std::size_t a_size)
+{
+    ++allocation_count;
+    if (auto ptr = std::malloc(a_size != 0 ? a_size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void * a_ptr) noexcept
+{
+    std::free(a_ptr);
+}
+
+void
+operator delete(void * a_ptr, std::size_t) noexcept
+{
+    std::free(a_ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Expose the steps of a game that are otherwise only run through its commands.
+class BenchGame : public wade::Game
+{
+public:
+    using Game::Game;
+    using Game::make_mines;
+    using Game::count_adjacent_mines;
+    using Game::show_more_board;
+    using Game::check_for_win;
+    using Game::hide_board;
+};
+
+// Stream buffer that throws away what is written, counting the bytes.
+class NullBuffer : public std::streambuf
+{
+public:
+    std::size_t bytes = 0;
+
+protected:
+    int_type overflow(int_type a_ch) override { ++bytes; return a_ch; }
+    std::streamsize xsputn(char const *, std::streamsize a_count) override { bytes += a_count; return a_count; }
+};
+
+struct Options
+{
+    double min_seconds = 0.2;
+    std::uint64_t seed = 1;
+    std::string filter = {};
+};
+
+struct Result
+{
+    std::string name = {};
+    wade::Settings settings = {};
+    std::size_t iterations = 0;
+    double ns_per_op = 0;
+    double cells_per_second = 0; // 0 for operations whose work does not grow with the board.
+    double allocations_per_op = 0;
+};
+
+// Time an operation until it has run for the minimum time. The operation returns the nanoseconds to count for it,
+// so it can leave setup work out, and adds the cells it processed.
+Result
+measure(std::string const & a_name, wade::Settings const & a_settings, Options const & a_options,
+    std::function<double(std::size_t & a_cells)> const & a_op)
+{
+    Result result{};
+    result.name = a_name;
+    result.settings = a_settings;
+
+    std::size_t cells = 0;
+    double ns = 0;
+    std::size_t allocations = 0;
+    auto const deadline = Clock::now() + std::chrono::duration<double>{a_options.min_seconds};
+    do
+    {
+        auto const allocations_before = allocation_count.load();
+        ns += a_op(cells);
+        allocations += allocation_count.load() - allocations_before;
+        ++result.iterations;
+    }
+    while (Clock::now() < deadline);
+
+    result.ns_per_op = ns / result.iterations;
+    result.cells_per_second = (ns > 0) ? cells / (ns * 1e-9) : 0;
+    result.allocations_per_op = static_cast<double>(allocations) / result.iterations;
+    return result;
+}
+
+// Time a callable, returning nanoseconds.
+template<typename Function>
+double
+time_ns(Function && a_function)
+{
+    auto const start = Clock::now();
+    a_function();
+    return std::chrono::duration<double, std::nano>{Clock::now() - start}.count();
+}
+
+// Find the empty cell that opens the largest area, so flood fill benchmarks do the most work.
+wade::Coord
+largest_opening(wade::Board const & a_real_board)
+{
+    wade::Board play{a_real_board.rows(), a_real_board.cols()};
+    play.hide();
+    wade::FloodFill fill{a_real_board};
+    wade::Coord best{};
+    std::size_t best_size = 0;
+    for (std::size_t i = 0; i != a_real_board.size(); ++i)
+    {
+        if (a_real_board[i] != wade::Cell::Zero or play[i] != wade::Cell::Hidden)
+        {
+            continue;
+        }
+        auto && revealed = fill.fill(a_real_board, play, i);
+        if (revealed.size() > best_size)
+        {
+            best_size = revealed.size();
+            best = a_real_board.coord(i);
+        }
+        for (auto && index : revealed)
+        {
+            play[index] = a_real_board[index];
+        }
+    }
+    return best;
+}
+
+// Script selecting every safe cell in row-major order, which wins the game.
+std::string
+winning_script(wade::Board const & a_real_board)
+{
+    std::ostringstream script{};
+    for (std::size_t i = 0; i != a_real_board.rows(); ++i)
+    {
+        for (std::size_t j = 0; j != a_real_board.cols(); ++j)
+        {
+            if (a_real_board.at(i, j) != wade::Cell::Mine)
+            {
+                script << "select " << i << ' ' << j << '\n';
+            }
+        }
+    }
+    return script.str();
+}
+
+void
+write_json(std::ostream & a_os, std::vector<Result> const & a_results, Options const & a_options)
+{
+    a_os << "{\n"
+        << "  \"seed\": " << a_options.seed << ",\n"
+        << "  \"min_seconds\": " << a_options.min_seconds << ",\n"
+        << "  \"metrics\": " << (WADE_METRICS ? "true" : "false") << ",\n"
+        << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i != a_results.size(); ++i)
+    {
+        auto && result = a_results[i];
+        a_os << "    {"
+            << "\"name\": \"" << result.name << "\""
+            << ", \"rows\": " << result.settings.rows
+            << ", \"cols\": " << result.settings.cols
+            << ", \"mines\": " << result.settings.mines
+            << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_op\": " << result.ns_per_op
+            << ", \"cells_per_sec\": ";
+        if (result.cells_per_second > 0)
+        {
+            a_os << result.cells_per_second;
+        }
+        else
+        {
+            a_os << "null";
+        }
+        a_os << ", \"allocations_per_op\": " << result.allocations_per_op
+            << "}" << ((i + 1 != a_results.size()) ? "," : "") << '\n';
+    }
+    a_os << "  ]\n"
+        << "}\n";
+}
+
+void
+write_usage(std::ostream & a_os)
+{
+    a_os << "usage: minesweeper_bench [options]\n"
+        << "  --filter <text>   Only run benchmarks whose name contains the text\n"
+        << "  --min-time <s>    Minimum seconds to run each benchmark (default 0.2)\n"
+        << "  --seed <n>        Seed for every board (default 1)\n"
+        ;
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+    Options options{};
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const option = argv[i];
+        if (option == "--help" or option == "-h" or i + 1 == argc)
+        {
+            write_usage(std::cerr);
+            return (option == "--help" or option == "-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        std::string const value = argv[++i];
+        if (option == "--filter")        { options.filter = value; }
+        else if (option == "--min-time") { options.min_seconds = std::strtod(value.c_str(), nullptr); }
+        else if (option == "--seed")     { options.seed = std::strtoull(value.c_str(), nullptr, 10); }
+        else
+        {
+            std::cerr << "Invalid option: '" << option << "'" << std::endl;
+            write_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Standard presets, then large boards at low, medium and expert-like densities.
+    std::vector<wade::Settings> boards = {
+          {9, 9, 10}
+        , {16, 16, 40}
+        , {16, 30, 99}
+        };
+    for (std::size_t size : {256, 1024})
+    {
+        for (double density : {0.05, 0.15, 0.21})
+        {
+            boards.push_back(wade::Settings{size, size, static_cast<std::size_t>(size * size * density)});
+        }
+    }
+    for (auto && settings : boards)
+    {
+        settings.seed = options.seed;
+    }
+
+    std::vector<Result> results{};
+    auto run =
+        [&results, &options](std::string const & a_name, wade::Settings const & a_settings,
+            std::function<double(std::size_t &)> const & a_op)
+        {
+            if (a_name.find(options.filter) == std::string::npos)
+            {
+                return;
+            }
+            results.push_back(measure(a_name, a_settings, options, a_op));
+            std::cerr << a_name << ' ' << a_settings << ": " << results.back().ns_per_op << " ns/op" << std::endl;
+        };
+
+    for (auto && settings : boards)
+    {
+        auto const cells = settings.rows * settings.cols;
+        // Find cells of interest on the board the game itself makes for the seed.
+        BenchGame game{settings};
+        auto const real = game.real_board();
+
+        run("board_construct", settings,
+            [&settings, cells](std::size_t & a_cells)
+            {
+                a_cells += cells;
+                return time_ns([&settings]() { wade::Board board{settings}; });
+            });
+
+        run("make_mines", settings,
+            [&game, &settings, cells](std::size_t & a_cells)
+            {
+                a_cells += cells;
+                return time_ns([&game, &settings]() { game.make_mines(settings.mines); });
+            });
+
+        run("count_adjacent_mines", settings,
+            [&game, cells](std::size_t & a_cells)
+            {
+                a_cells += cells;
+                return time_ns([&game]() { game.count_adjacent_mines(); });
+            });
+
+        // Reveal the largest opening on a freshly hidden board each time.
+        auto const opening = largest_opening(real);
+        game.restart(settings.seed);
+        run("show_more_board", settings,
+            [&game, &opening](std::size_t & a_cells)
+            {
+                game.hide_board();
+                auto const ns = time_ns([&game, &opening]() { game.show_more_board(opening); });
+                a_cells += game.revealed_count();
+                return ns;
+            });
+
+        // The win check compares counts, so it processes no cells.
+        run("check_for_win", settings,
+            [&game](std::size_t &)
+            {
+                return time_ns([&game]() { game.check_for_win(); });
+            });
+
+        run("board_write", settings,
+            [&game, cells](std::size_t & a_cells)
+            {
+                NullBuffer buffer{};
+                std::ostream os{&buffer};
+                a_cells += cells;
+                return time_ns([&game, &os]() { os << game.play_board(); });
+            });
+
+        // Full games through the text interface are only practical on small boards.
+        if (cells <= 16 * 30)
+        {
+            auto const script = winning_script(real);
+            run("scripted_game", settings,
+                [&settings, &script, cells](std::size_t & a_cells)
+                {
+                    std::istringstream is{script};
+                    NullBuffer buffer{};
+                    std::ostream os{&buffer};
+                    a_cells += cells;
+                    return time_ns(
+                        [&settings, &is, &os]()
+                        {
+                            wade::Game scripted{settings};
+                            scripted.play(is, os);
+                        });
+                });
+        }
+    }
+
+    write_json(std::cout, results, options);
+    return EXIT_SUCCESS;
+}
+
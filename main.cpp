@@ -1,13 +1,316 @@
+#include "Batch.hpp"
+#include "Board.hpp"
+#include "ChunkedBoard.hpp"
+#include "Command.hpp"
+#include "Game.hpp"
 #include "GameSession.hpp"
+#include "Metrics.hpp"
+#include "Recorder.hpp"
+#include "Renderer.hpp"
+#include "Replay.hpp"
+#include "Script.hpp"
+#include "Server.hpp"
+#include "Snapshot.hpp"
+#include "Settings.hpp"
 
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Longest interval between metrics lines, in seconds: a day.
+constexpr std::size_t max_metrics_every = 24 * 60 * 60;
+
+// Server to stop on SIGINT or SIGTERM.
+wade::Server * running_server = nullptr;
+
+void
+stop_server(int)
+{
+    if (running_server)
+    {
+        running_server->stop();
+    }
+}
+
+// Play on a chunked board, drawing the area around the last command's square.
+void
+play_chunked(wade::ChunkedBoard & a_board, std::istream & a_is, std::ostream & a_os)
+{
+    wade::Board window{20, 40};
+    wade::Renderer renderer{};
+    wade::Coord center{};
+    a_os << "Board is unbounded; select 0 0 to start. Seed: " << a_board.seed() << '\n';
+
+    std::string line{};
+    while (1)
+    {
+        auto const top_left = center - wade::Coord{
+            static_cast<std::int64_t>(window.rows() / 2), static_cast<std::int64_t>(window.cols() / 2)};
+        a_board.view(top_left, window);
+        a_os << "Rows from " << top_left.row << ", columns from " << top_left.col << '\n';
+        renderer.write(window, a_os);
+        a_os << "Revealed: " << a_board.revealed_count() << " Flagged: " << a_board.flagged_count()
+            << " Tiles: " << a_board.cached_tiles() << " cached, " << a_board.explored_tiles() << " explored\n"
+            << "Enter command (select, flag or quit): " << std::flush;
+        if (not std::getline(a_is, line))
+        {
+            return;
+        }
+
+        auto const command = wade::Command::parse(line.data(), line.data() + line.size());
+        if (command.type == wade::Command::Type::Quit)
+        {
+            return;
+        }
+        if ((command.type != wade::Command::Type::Select and command.type != wade::Command::Type::Flag)
+            or not command.valid
+            )
+        {
+            a_os << "Usage: select <row> <col> | flag <row> <col> | quit\n";
+            continue;
+        }
+
+        if (not wade::ChunkedBoard::is_valid(command.coord))
+        {
+            a_os << "Rows and columns must be from " << -wade::ChunkedBoard::limit
+                << " to " << wade::ChunkedBoard::limit - 1 << '\n';
+            continue;
+        }
+
+        center = command.coord;
+        if (command.type == wade::Command::Type::Flag)
+        {
+            a_board.toggle_flag(command.coord);
+        }
+        else if (not a_board.select(command.coord))
+        {
+            a_os << "Boom! Mine at " << command.coord << ". Revealed " << a_board.revealed_count() << " squares.\n";
+            return;
+        }
+    }
+}
+
+void
+write_usage(std::ostream & a_os)
+{
+    a_os << "usage: minesweeper [options]\n"
+        << "  --rows <n>        Board rows (default 9)\n"
+        << "  --cols <n>        Board columns (default 9)\n"
+        << "  --mines <n>       Number of mines (default 10)\n"
+        << "  --no-guess <0|1>  Only play boards that can be solved without guessing (default 0)\n"
+        << "  --seed <n>        Seed for mine placement; 0 picks a random seed (default 0)\n"
+        << "  --ansi            Redraw only the squares that change, for slow terminals\n"
+        << "  --batch <file>    Run commands from a script, or standard input if '-', writing only the result\n"
+        << "  --status          With --batch, also write a status line for each command\n"
+        << "  --restore <file>  Resume a game saved with the save command, interactively or with --batch\n"
+        << "  --record <file>   Log every command applied to the game, to replay it exactly later\n"
+        << "  --replay <file>   Replay a logged game at full speed, writing only the result\n"
+        << "  --seek <n>        With --replay, stop after the first n moves (default all)\n"
+        << "  --chunked <p>     Play an unbounded board where each square is a mine with probability p\n"
+        << "  --cache-mb <n>    With --chunked, memory for generated tiles in MiB (default 64)\n"
+        << "  --server <path>   Serve one game per connection on a Unix socket at the path\n"
+        << "  --workers <n>     With --server, threads for slow commands on big boards (default 2)\n"
+        << "  --metrics <file>  Write the metrics the stats command shows to the file as JSON lines, periodically\n"
+        << "  --every <s>       With --metrics, seconds between lines, at most a day (default 10)\n"
+        ;
+}
+
+}
 
 int main(int argc, char * argv[])
 {
     std::ios::sync_with_stdio(false);
-    wade::GameSession game_session{};
+
+    wade::Settings settings{9, 9, 10};
+    auto render_mode = wade::Renderer::Mode::Full;
+    std::string batch_path{};
+    std::string server_path{};
+    std::string restore_path{};
+    std::string record_path{};
+    std::string replay_path{};
+    std::size_t seek = static_cast<std::size_t>(-1);
+    std::size_t workers = 2;
+    double chunked_density = NAN;
+    std::size_t cache_mb = 64;
+    std::string metrics_path{};
+    std::size_t metrics_every = 10;
+    bool status = false;
+
+    // Parse options: flags take no value, the rest take one.
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const option = argv[i];
+        if (option == "--ansi")        { render_mode = wade::Renderer::Mode::Incremental; continue; }
+        else if (option == "--status") { status = true; continue; }
+        else if (option == "--help" or option == "-h" or i + 1 == argc)
+        {
+            write_usage(std::cerr);
+            return (option == "--help" or option == "-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        char const * value = argv[++i];
+        auto number = [value]() { return std::strtoull(value, nullptr, 10); };
+        if (option == "--rows")          { settings.rows = number(); }
+        else if (option == "--cols")     { settings.cols = number(); }
+        else if (option == "--mines")    { settings.mines = number(); }
+        else if (option == "--seed")     { settings.seed = number(); }
+        else if (option == "--no-guess") { settings.no_guess = (number() != 0); }
+        else if (option == "--batch")    { batch_path = value; }
+        else if (option == "--server")   { server_path = value; }
+        else if (option == "--restore")  { restore_path = value; }
+        else if (option == "--record")   { record_path = value; }
+        else if (option == "--replay")   { replay_path = value; }
+        else if (option == "--seek")     { seek = number(); }
+        else if (option == "--workers")  { workers = number(); }
+        else if (option == "--chunked")  { chunked_density = std::strtod(value, nullptr); }
+        else if (option == "--cache-mb") { cache_mb = number(); }
+        else if (option == "--metrics")  { metrics_path = value; }
+        else if (option == "--every")    { metrics_every = number(); }
+        else
+        {
+            std::cerr << "Invalid option: '" << option << "'" << std::endl;
+            write_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.rows == 0 or settings.cols == 0)
+    {
+        std::cerr << "Board must have at least 1 row and 1 column" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (metrics_every == 0 or metrics_every > max_metrics_every)
+    {
+        std::cerr << "Metrics interval must be from 1 to " << max_metrics_every << " seconds" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Dump the metrics while the program runs, and once more as it exits.
+    std::ofstream metrics_file{};
+    std::unique_ptr<wade::MetricsDump> metrics_dump{};
+    if (not metrics_path.empty())
+    {
+        metrics_file.open(metrics_path, std::ios::trunc);
+        if (not metrics_file)
+        {
+            std::cerr << "Cannot write metrics '" << metrics_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+        metrics_dump.reset(new wade::MetricsDump{metrics_file, std::chrono::seconds{metrics_every}});
+    }
+
+    if (not std::isnan(chunked_density))
+    {
+        wade::ChunkedBoard board{settings.seed, chunked_density, cache_mb << 20};
+        play_chunked(board, std::cin, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    if (not replay_path.empty())
+    {
+        wade::Script log{};
+        wade::Replay replay{};
+        if (not log.open(replay_path))
+        {
+            std::cerr << "Cannot read log '" << replay_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (not replay.open(log.begin(), log.end()))
+        {
+            std::cerr << "Cannot replay '" << replay_path << "': not a valid game log" << std::endl;
+            return EXIT_FAILURE;
+        }
+        replay.seek(seek);
+        auto && game = replay.game();
+        std::cout << "result=" << game.result()
+            << " moves=" << replay.position() << '/' << replay.moves().size()
+            << " revealed=" << game.revealed_count()
+            << " flagged=" << game.flagged_count()
+            << " seed=" << game.seed()
+            << '\n';
+        return EXIT_SUCCESS;
+    }
+
+    // A recorded game must be replayable from its start.
+    std::ofstream record_file{};
+    std::unique_ptr<wade::Recorder> recorder{};
+    if (not record_path.empty())
+    {
+        if (not restore_path.empty())
+        {
+            std::cerr << "Cannot record a restored game" << std::endl;
+            return EXIT_FAILURE;
+        }
+        record_file.open(record_path, std::ios::binary | std::ios::trunc);
+        if (not record_file)
+        {
+            std::cerr << "Cannot write log '" << record_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+        recorder.reset(new wade::Recorder{record_file});
+    }
+
+    // A restored game keeps its own settings.
+    std::unique_ptr<wade::Game> restored{};
+    if (not restore_path.empty())
+    {
+        restored = wade::Snapshot::load(restore_path);
+        if (not restored)
+        {
+            std::cerr << "Cannot restore game from '" << restore_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (not batch_path.empty())
+    {
+        wade::Script script{};
+        if (not script.open(batch_path))
+        {
+            std::cerr << "Cannot read script '" << batch_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+        auto game = restored ? std::move(restored) : std::unique_ptr<wade::Game>{new wade::Game{settings}};
+        game->set_recorder(recorder.get());
+        wade::Batch batch{*game, status};
+        batch.run(script.begin(), script.end(), std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    if (not server_path.empty())
+    {
+        wade::Server server{settings, workers};
+        if (not server.listen(server_path))
+        {
+            std::cerr << "Cannot listen on '" << server_path << "': " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+        running_server = &server;
+        std::signal(SIGINT, stop_server);
+        std::signal(SIGTERM, stop_server);
+        server.run();
+        running_server = nullptr;
+        std::cout << server.stats() << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (restored)
+    {
+        restored->renderer().set_mode(render_mode);
+        restored->play(std::cin, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    wade::GameSession game_session{settings, render_mode};
+    game_session.set_recorder(recorder.get());
     game_session.play(std::cin, std::cout);
     return EXIT_SUCCESS;
 }
-
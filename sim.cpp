@@ -0,0 +1,139 @@
+#include "Settings.hpp"
+#include "Simulator.hpp"
+#include "Stats.hpp"
+#include "Strategy.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+void
+write_usage(std::ostream & a_os)
+{
+    a_os << "usage: minesweeper_sim [options]\n"
+        << "  --games <n>       Number of games to play (default 1000)\n"
+        << "  --rows <n>        Board rows (default 9)\n"
+        << "  --cols <n>        Board columns (default 9)\n"
+        << "  --mines <n>       Number of mines (default 10)\n"
+        << "  --no-guess <0|1>  Only play boards that can be solved without guessing (default 0)\n"
+        << "  --seed <n>        Base seed the game seeds are derived from; 0 picks a random seed (default 0)\n"
+        << "  --threads <n>     Worker threads; 0 uses every hardware thread (default 0)\n"
+        << "  --strategy <name> Strategy to play with: random, solver, probability (default random)\n"
+        << "  --analyze <0|1>   Only analyze the boards for openings, isolated numbers and 3BV (default 0)\n"
+        ;
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+    std::ios::sync_with_stdio(false);
+
+    wade::Settings settings{9, 9, 10};
+    std::size_t games = 1000;
+    std::size_t threads = 0;
+    std::string strategy = "random";
+    bool analyze = false;
+
+    // Parse options: each takes one value.
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const option = argv[i];
+        if (option == "--help" or option == "-h" or i + 1 == argc)
+        {
+            write_usage(std::cerr);
+            return (option == "--help" or option == "-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        char const * value = argv[++i];
+        auto number = [value]() { return std::strtoull(value, nullptr, 10); };
+        if (option == "--games")         { games = number(); }
+        else if (option == "--rows")     { settings.rows = number(); }
+        else if (option == "--cols")     { settings.cols = number(); }
+        else if (option == "--mines")    { settings.mines = number(); }
+        else if (option == "--seed")     { settings.seed = number(); }
+        else if (option == "--no-guess") { settings.no_guess = (number() != 0); }
+        else if (option == "--threads")  { threads = number(); }
+        else if (option == "--strategy") { strategy = value; }
+        else if (option == "--analyze")  { analyze = (number() != 0); }
+        else
+        {
+            std::cerr << "Invalid option: '" << option << "'" << std::endl;
+            write_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.rows == 0 or settings.cols == 0)
+    {
+        std::cerr << "Board must have at least 1 row and 1 column" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (analyze and settings.no_guess)
+    {
+        std::cerr << "Cannot analyze no-guess boards: their mines are placed on the first select" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    wade::Simulator::StrategyFactory strategy_factory{};
+    if (strategy == "random")
+    {
+        strategy_factory = []() { return std::unique_ptr<wade::Strategy>{new wade::RandomStrategy{}}; };
+    }
+    else if (strategy == "solver")
+    {
+        strategy_factory = []() { return std::unique_ptr<wade::Strategy>{new wade::SolverStrategy{}}; };
+    }
+    else if (strategy == "probability")
+    {
+        strategy_factory = []() { return std::unique_ptr<wade::Strategy>{new wade::ProbabilityStrategy{}}; };
+    }
+    else
+    {
+        std::cerr << "Invalid strategy: '" << strategy << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    wade::ThreadPool pool{threads};
+    wade::Simulator simulator{settings, strategy_factory};
+
+    if (analyze)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        auto const stats = simulator.analyze(games, pool);
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << settings
+            << ", boards=" << games
+            << ", threads=" << pool.size()
+            << ", base_seed=" << simulator.seed()
+            << '\n'
+            << stats << '\n'
+            << "seconds=" << elapsed.count()
+            << ", boards_per_second=" << (games / elapsed.count())
+            << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const stats = simulator.run(games, pool);
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << settings
+        << ", games=" << games
+        << ", threads=" << pool.size()
+        << ", strategy=" << strategy
+        << ", base_seed=" << simulator.seed()
+        << '\n'
+        << stats << '\n'
+        << "seconds=" << elapsed.count()
+        << ", games_per_second=" << (games / elapsed.count())
+        << std::endl;
+
+    return EXIT_SUCCESS;
+}
+